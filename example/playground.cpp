@@ -24,7 +24,7 @@ int main(int argc, char** argv) {
   std::string file(argv[2]);
 
   xs::Searcher<xs::FileReader<xs::strtype>, xs::LineSearcher<xs::strtype>, xs::Result<xs::PartRes1<std::string>>, xs::PartRes1<std::string>, void> searcher(
-      xs::FileReader(file), xs::LineSearcher(pattern), 1);
+      xs::FileReader<xs::strtype>(file), xs::LineSearcher<xs::strtype>(pattern), 1);
   auto res = searcher.execute<xs::execute::live>();
 
   for (const auto& pr : res.get()) {
@@ -0,0 +1,49 @@
+/**
+ * Copyright 2023, Leon Freist (https://github.com/lfreist)
+ * Author: Leon Freist <freist.leon@gmail.com>
+ *
+ * This file is part of x-search.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace xs {
+
+/**
+ * Container formats recognized by their magic bytes. Files that were split into chunks by preprocessing (c.f.
+ *  xs::preprocess()) are recognized by their meta file instead: chunks compressed using LZ4 have no magic bytes.
+ */
+enum class FileFormat { PLAIN, GZIP, ZSTD, LZ4_FRAME };
+
+std::string to_string(FileFormat format);
+
+/// format of data starting with the size bytes at data (PLAIN if no magic bytes are recognized)
+FileFormat detect_format(const char* data, size_t size);
+
+/// format of the file at path, determined by its first bytes. Throws std::runtime_error if the file cannot be read
+FileFormat detect_format(const std::string& path);
+
+/**
+ * Sequential decompression of a compressed file (multiple concatenated frames or members are decompressed one after
+ *  another). Used for formats that cannot be decompressed in parallel (ZSTD and LZ4 frames not split by
+ *  preprocessing).
+ */
+class StreamDecoder {
+ public:
+  virtual ~StreamDecoder() = default;
+
+  /**
+   * Decompress up to size bytes into dest. Less than size bytes are returned only at the end of the data.
+   *  Throws std::runtime_error if the data is corrupted or truncated.
+   */
+  virtual size_t read(char* dest, size_t size) = 0;
+
+  /// decoder of format reading the file opened as fd (not owned, not read by others) from its beginning
+  static std::unique_ptr<StreamDecoder> create(FileFormat format, int fd);
+};
+
+}  // namespace xs
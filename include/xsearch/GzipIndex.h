@@ -0,0 +1,119 @@
+/**
+ * Copyright 2023, Leon Freist (https://github.com/lfreist)
+ * Author: Leon Freist <freist.leon@gmail.com>
+ *
+ * This file is part of x-search.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace xs {
+
+/**
+ * Index of inflate checkpoints of a gzip file (c.f. zran.c of zlib): every checkpoint holds the state needed to start
+ *  inflating in the middle of the deflate stream, so that disjoint regions of the file can be inflated independently.
+ *
+ * Format of the index file (native byte order):
+ *  "XSGZI001", uint64 compressed size, uint64 uncompressed size, uint64 span, uint64 number of points,
+ *  per point: uint64 out, uint64 in, uint8 bits, uint32 window size, window
+ */
+class GzipIndex {
+ public:
+  struct Point {
+    /// offset of the checkpoint within the uncompressed data
+    uint64_t out = 0;
+    /// offset of the first complete byte of the deflate block within the compressed file
+    uint64_t in = 0;
+    /// number of bits of the byte preceding in that belong to the block (0-7)
+    int bits = 0;
+    /// up to 32 KiB of uncompressed data preceding out (the dictionary inflate continues with)
+    std::string window;
+  };
+
+  GzipIndex() = default;
+  GzipIndex(uint64_t compressed_size, uint64_t uncompressed_size, uint64_t span, std::vector<Point> points);
+
+  /**
+   * Load the index stored at index_path. Returns std::nullopt if the file does not exist, is not an index or does not
+   *  belong to a gzip file of compressed_size bytes (e.g. the gzip file was replaced).
+   */
+  static std::optional<GzipIndex> load(const std::string& index_path, uint64_t compressed_size);
+
+  /// write the index to index_path. Throws std::runtime_error if the file cannot be written
+  void save(const std::string& index_path) const;
+
+  [[nodiscard]] const std::vector<Point>& points() const { return _points; }
+  [[nodiscard]] uint64_t compressed_size() const { return _compressed_size; }
+  [[nodiscard]] uint64_t uncompressed_size() const { return _uncompressed_size; }
+  /// (minimal) distance of checkpoints in uncompressed bytes
+  [[nodiscard]] uint64_t span() const { return _span; }
+
+ private:
+  uint64_t _compressed_size = 0;
+  uint64_t _uncompressed_size = 0;
+  uint64_t _span = 0;
+  std::vector<Point> _points;
+};
+
+/**
+ * Inflates (multi member) gzip data read from a file descriptor using pread(), so that multiple inflaters can share
+ *  one file descriptor.
+ *
+ * Inflating from the beginning of the file, a GzipIndex with checkpoints every span uncompressed bytes is built as
+ *  a side effect (c.f. index()). Inflating from a checkpoint starts in the middle of the file.
+ */
+class GzipInflater {
+ public:
+  /// inflate from the beginning of the file, building an index with checkpoints every span bytes
+  GzipInflater(int fd, uint64_t compressed_size, uint64_t span);
+  /// inflate from point (no index is built)
+  GzipInflater(int fd, uint64_t compressed_size, const GzipIndex::Point& point);
+  ~GzipInflater();
+
+  GzipInflater(const GzipInflater&) = delete;
+  GzipInflater& operator=(const GzipInflater&) = delete;
+
+  /**
+   * Inflate up to size bytes into dest. Less than size bytes are returned only at the end of the data.
+   *  Throws std::runtime_error if the data is corrupted.
+   */
+  size_t read(char* dest, size_t size);
+
+  /// true if all data was inflated
+  [[nodiscard]] bool done() const { return _done; }
+
+  /// the index built so far (complete once done() is true)
+  [[nodiscard]] GzipIndex index() const;
+
+ private:
+  /// read more compressed input, returns false at the end of the file
+  bool fill_input();
+  /// after the end of a member: start the next one (if any)
+  void next_member();
+  void update_window(const char* data, size_t size);
+  void add_point();
+
+  struct Stream;
+  std::unique_ptr<Stream> _stream;
+  int _fd;
+  uint64_t _compressed_size;
+  uint64_t _in_offset = 0;
+  uint64_t _total_out = 0;
+  bool _done = false;
+  /// the stream is a raw deflate stream (inflating from a checkpoint) until the end of the current member
+  bool _raw = false;
+
+  // index building (span == 0: no index is built)
+  uint64_t _span = 0;
+  std::vector<GzipIndex::Point> _points;
+  std::vector<char> _window;
+  size_t _window_pos = 0;
+};
+
+}  // namespace xs
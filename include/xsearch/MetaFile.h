@@ -0,0 +1,122 @@
+/**
+ * Copyright 2023, Leon Freist (https://github.com/lfreist)
+ * Author: Leon Freist <freist.leon@gmail.com>
+ *
+ * This file is part of x-search.
+ */
+
+#pragma once
+
+#include <xsearch/types.h>
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <ios>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace xs {
+
+/// MIXED: every chunk has its own compression type (ChunkMetaData::compression_type), c.f. xs::preprocess()
+enum class CompressionType : int32_t { UNKNOWN = 0, NONE = 1, ZSTD = 2, LZ4 = 3, MIXED = 4 };
+
+std::string to_string(CompressionType compression_type);
+
+/**
+ * Meta data of one chunk of a preprocessed (possibly compressed) file.
+ *  original_*: location of the chunk within the original (uncompressed) file
+ *  actual_*: location of the (compressed) chunk within the preprocessed file
+ */
+struct ChunkMetaData {
+  uint64_t original_offset = 0;
+  uint64_t actual_offset = 0;
+  uint64_t original_size = 0;
+  uint64_t actual_size = 0;
+  std::vector<ByteToNewLineMappingInfo> line_mapping_data;
+  /// compression type of the chunk (NONE, LZ4 or ZSTD) in MIXED meta files, UNKNOWN otherwise (type of the file)
+  CompressionType compression_type = CompressionType::UNKNOWN;
+
+  bool operator==(const ChunkMetaData&) const = default;
+};
+
+/**
+ * Sidecar file holding the chunk meta data of a preprocessed file.
+ *
+ * Format (native byte order):
+ *  int32 compression type, or'ed with dictionary_flag if a dictionary follows
+ *  [uint64 dictionary size, dictionary bytes] (only if dictionary_flag is set)
+ *  per chunk: uint64 original_offset, actual_offset, original_size, actual_size, number of mappings n,
+ *             [uint64 compression type of the chunk] (only if the compression type of the file is MIXED)
+ *             followed by n pairs of uint64 (globalByteOffset, globalLineIndex)
+ *
+ * std::ios::in: the file is memory-mapped and indexed once (the positions of all chunk records are collected), so
+ *  that any chunk can be accessed directly (chunk_meta_data(k)). next_chunk_meta_data() hands out the chunks in
+ *  order and may be called by multiple threads concurrently: every chunk is handed out exactly once.
+ * std::ios::out: chunk meta data is appended using write(). Chunks must be written in order.
+ *
+ * The dictionary holds data all chunks were compressed with (e.g. a trained ZSTD dictionary, c.f. xs::preprocess()).
+ *  Meta files without dictionary are written exactly as before.
+ */
+class MetaFile {
+ public:
+  static constexpr int32_t dictionary_flag = 1 << 16;
+
+  MetaFile(std::string file_path, std::ios::openmode mode, CompressionType compression_type = CompressionType::NONE,
+           std::string_view dictionary = {});
+  ~MetaFile();
+
+  /// not copyable/movable: the mapping and the chunk cursor are shared by the threads reading it
+  MetaFile(const MetaFile&) = delete;
+  MetaFile(MetaFile&&) = delete;
+  MetaFile& operator=(const MetaFile&) = delete;
+  MetaFile& operator=(MetaFile&&) = delete;
+
+  [[nodiscard]] CompressionType get_compression_type() const;
+
+  /// the dictionary the chunks were compressed with (empty if there is none). Points into the mapped file (read mode)
+  [[nodiscard]] std::string_view dictionary() const;
+
+  /// meta data of the next chunk, std::nullopt if all chunks were handed out
+  std::optional<ChunkMetaData> next_chunk_meta_data();
+
+  /**
+   * Index of the next chunk (to be read using chunk_meta_data()), std::nullopt if all chunks were handed out. Shares
+   *  the cursor with next_chunk_meta_data().
+   */
+  std::optional<size_t> next_chunk_index();
+
+  /// meta data of the index-th chunk, std::nullopt if there is no such chunk
+  [[nodiscard]] std::optional<ChunkMetaData> chunk_meta_data(size_t index) const;
+
+  /// number of chunks (read mode)
+  [[nodiscard]] size_t num_chunks() const;
+
+  /// append the meta data of the next chunk (write mode). Throws std::runtime_error if the compression type of the chunk
+  ///  is not NONE, LZ4 or ZSTD in a MIXED meta file
+  void write(const ChunkMetaData& chunk_meta_data);
+
+ private:
+  void index();
+  /// size of the fixed part of a chunk record, preceding its line mapping data
+  [[nodiscard]] size_t chunk_header_size() const;
+
+  std::string _file_path;
+  CompressionType _compression_type = CompressionType::UNKNOWN;
+  std::string_view _dictionary;
+
+  // read mode
+  int _fd = -1;
+  const char* _data = nullptr;
+  size_t _size = 0;
+  /// byte offset of every chunk record within the file
+  std::vector<size_t> _chunk_positions;
+  std::atomic<size_t> _next_chunk_index{0};
+
+  // write mode
+  std::ofstream _out;
+};
+
+}  // namespace xs
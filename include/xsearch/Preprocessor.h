@@ -0,0 +1,72 @@
+/**
+ * Copyright 2023, Leon Freist (https://github.com/lfreist)
+ * Author: Leon Freist <freist.leon@gmail.com>
+ *
+ * This file is part of x-search.
+ */
+
+#pragma once
+
+#include <xsearch/MetaFile.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace xs {
+
+/**
+ * Options of xs::preprocess().
+ */
+struct PreprocessOptions {
+  /// ADAPTIVE: every chunk is stored raw, LZ4 or ZSTD compressed, whatever pays off (c.f. lz4_decode_cost)
+  enum class Algorithm { NONE, LZ4, LZ4_HC, ZSTD, ADAPTIVE };
+
+  Algorithm algorithm = Algorithm::LZ4;
+  /// compression level, 0: default level of the algorithm (ignored by NONE and LZ4, ZSTD level for ADAPTIVE)
+  int level = 0;
+  /// chunks end with the last new line char within chunk_size bytes (or grow until a new line char is found)
+  size_t chunk_size = 16 * (1 << 20);
+  /// number of chunks compressed in parallel
+  size_t num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+  /// a line mapping point is stored for the first line starting at least mapping_distance bytes after the previous one
+  size_t mapping_distance = 500;
+  /**
+   * ZSTD only: if > 0, a dictionary of at most dictionary_size bytes (e.g. 112640) is trained on the first
+   *  100 * dictionary_size bytes of the input and stored in the meta file. All chunks are compressed using it, which
+   *  makes up for most of the ratio lost by compressing small chunks independently. Also used by ADAPTIVE.
+   */
+  size_t dictionary_size = 0;
+  /**
+   * ADAPTIVE only: decode cost of LZ4 and ZSTD, given in bytes per decompressed byte. Every chunk is compressed using
+   *  both algorithms and stored using the one with the smallest compressed size + decode cost * chunk size (raw
+   *  chunks cost nothing to decode). E.g. LZ4 is used only if it saves more than 10 % of a chunk, ZSTD only if it
+   *  additionally saves 15 % compared to LZ4. Incompressible chunks (e.g. base64 payloads) are stored raw.
+   */
+  double lz4_decode_cost = 0.1;
+  double zstd_decode_cost = 0.25;
+};
+
+/// compression type stored in the meta file for algorithm
+CompressionType compression_type(PreprocessOptions::Algorithm algorithm);
+
+/// default file extension of files preprocessed using algorithm (e.g. ".xslz4")
+std::string file_extension(PreprocessOptions::Algorithm algorithm);
+
+/**
+ * Split the file at input_path ("-" for stdin) into newline aligned chunks and compress every chunk independently
+ *  (c.f. xs::LZ4ChunkReader, xs::ZstdChunkReader), so that the chunks can be decompressed and searched in parallel.
+ *  The compressed chunks are written to output_path, their meta data (c.f. xs::MetaFile) to meta_file_path.
+ *
+ * The input is read by the calling thread while num_threads threads compress the chunks read before. The compressed
+ *  chunks are written in input order by the thread that compressed them, at most num_threads chunks are in flight.
+ *  If algorithm is NONE and output_path is empty, only the meta file is written: it describes the chunks of the input
+ *  file itself (c.f. xs::ChunkReader).
+ *
+ * Throws std::runtime_error if a file cannot be read or written or compression fails.
+ */
+void preprocess(const std::string& input_path, const std::string& output_path, const std::string& meta_file_path,
+                const PreprocessOptions& options = {});
+
+}  // namespace xs
@@ -9,8 +9,13 @@
 
 #include <xsearch/utils/Synchronized.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <tuple>
 #include <vector>
 
@@ -34,14 +39,14 @@ class Result {
   template <typename R>
   class iterator {
    public:
-    explicit iterator(R& result) : _result(result), _current_index(0) {}
+    explicit iterator(R& result) : _current_index(0), _result(result) {}
 
     iterator& operator++() {
       _current_index++;
       return *this;
     }
 
-    PartResT& operator*() {
+    const PartResT& operator*() {
       return _result[_current_index];
     }
 
@@ -67,7 +72,7 @@ class Result {
   using Iterator = iterator<Result<PartResT>>;
 
  public:
-  Result() = default;
+  Result() : _m(std::make_unique<std::mutex>()), _cv(std::make_unique<std::condition_variable>()) {}
   ~Result() = default;
 
   /// not copyable
@@ -115,6 +120,8 @@ class Result {
   bool is_closed() const { return _closed.load(); }
 
   void close() {
+    // under the lock: an iterator cannot miss the notification between checking is_closed() and waiting
+    std::unique_lock lock(*_m);
     _closed.store(true);
     _cv->notify_all();
   }
@@ -129,4 +136,80 @@ class Result {
   std::unique_ptr<std::condition_variable> _cv;
 };
 
-}  // namespace xs
\ No newline at end of file
+/**
+ * Result whose partial results are stored in source order: xs::Searcher passes the sequence number of the searched
+ *  chunk along with its partial result (c.f. xs::OrderedResultC), partial results that arrive early wait in a reorder
+ *  window and are released as soon as all their predecessors arrived. Readers of the result (e.g. the iterator) see
+ *  the partial results in file order while the search is still running, without sorting them afterwards.
+ *
+ * The window holds at most window_size partial results: threads adding results further ahead block until the gap is
+ *  closed. window_size must therefore exceed the number of chunks that are searched at the same time (number of
+ *  search threads, plus the queue capacity of pipelined searchers).
+ */
+template <typename PartResT>
+class OrderedResult : public Result<PartResT> {
+ public:
+  explicit OrderedResult(size_t window_size = 1024)
+      : _window_size(window_size < 1 ? 1 : window_size),
+        _window_mutex(std::make_unique<std::mutex>()),
+        _window_cv(std::make_unique<std::condition_variable>()) {}
+
+  /// unordered add, c.f. Result::add()
+  using Result<PartResT>::add;
+
+  /**
+   * Add the partial result of the chunk with sequence_number (std::nullopt: the chunk did not produce one). Every
+   *  sequence number must be added exactly once.
+   */
+  bool add(uint64_t sequence_number, std::optional<PartResT> pr) {
+    std::unique_lock lock(*_window_mutex);
+    _window_cv->wait(lock, [&]() { return sequence_number < _next + _window_size || this->is_closed(); });
+    if (this->is_closed()) {
+      return false;
+    }
+    if (sequence_number != _next) {
+      _pending.emplace(sequence_number, std::move(pr));
+      return true;
+    }
+    release(std::move(pr));
+    while (!_pending.empty() && _pending.begin()->first == _next) {
+      release(std::move(_pending.begin()->second));
+      _pending.erase(_pending.begin());
+    }
+    _window_cv->notify_all();
+    return true;
+  }
+
+  /// release the partial results still waiting for a predecessor (in order) and close the result
+  void close() {
+    std::unique_lock lock(*_window_mutex);
+    for (auto& [sequence_number, pr] : _pending) {
+      release(std::move(pr));
+    }
+    _pending.clear();
+    Result<PartResT>::close();
+    _window_cv->notify_all();
+  }
+
+  /// number of partial results waiting for a predecessor
+  size_t num_pending() const {
+    std::unique_lock lock(*_window_mutex);
+    return _pending.size();
+  }
+
+ private:
+  void release(std::optional<PartResT>&& pr) {
+    if (pr) {
+      Result<PartResT>::add(std::move(pr.value()));
+    }
+    _next++;
+  }
+
+  size_t _window_size;
+  uint64_t _next = 0;
+  std::map<uint64_t, std::optional<PartResT>> _pending;
+  std::unique_ptr<std::mutex> _window_mutex;
+  std::unique_ptr<std::condition_variable> _window_cv;
+};
+
+}  // namespace xs
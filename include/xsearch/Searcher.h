@@ -8,17 +8,27 @@
 #pragma once
 
 #include <xsearch/concepts.h>
+#include <xsearch/utils/RingQueue.h>
 #include <xsearch/utils/Semaphore.h>
 #include <xsearch/utils/Synchronized.h>
+#include <xsearch/utils/ThreadPool.h>
 #include <xsearch/utils/UninitializedAllocator.h>
 #include <xsearch/utils/utils.h>
 #include <xsearch/types.h>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <coroutine>
+#include <exception>
 #include <future>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <semaphore>
+#include <stop_token>
 #include <string>
 #include <thread>
 #include <vector>
@@ -27,10 +37,59 @@ namespace xs {
 
 enum class execute { async, blocking, live, lazy };
 
+/**
+ * Pipelined topology of xs::Searcher: num_io_threads threads only read chunks and push them into a bounded queue of
+ *  queue_capacity chunks, the search threads only pop and search them. Reading and searching overlap completely and
+ *  both stages are sized independently (e.g. a single reader thread for a sequential reader feeding all cores).
+ */
+struct Pipeline {
+  int num_io_threads = 1;
+  size_t queue_capacity = 16;
+};
+
 template <typename ReaderT, typename SearcherT, typename ResultT, typename PartResT, typename ResIterator,
           typename DataT = strtype>
   requires ReaderC<ReaderT, DataT> && SearcherC<SearcherT, PartResT, DataT> && ResultC<ResultT, PartResT>
 class Searcher {
+ public:  // --- public types ------------------------------------------------------------------------------------------
+  /**
+   * Range of the partial results of a lazily executed Searcher (c.f. execute::lazy). Single pass: advancing the
+   *  iterator pulls the next partial result, reading and searching further chunks as needed. Empty partial results
+   *  are skipped. Valid as long as the Searcher is alive.
+   */
+  class LazyResults {
+   public:
+    class iterator {
+     public:
+      iterator() = default;
+      iterator(Searcher* searcher, std::optional<PartResT> current)
+          : _searcher(searcher), _current(std::move(current)) {}
+
+      const PartResT& operator*() const { return _current.value(); }
+      const PartResT* operator->() const { return &_current.value(); }
+
+      iterator& operator++() {
+        _current = _searcher->lazy_next();
+        return *this;
+      }
+
+      bool operator!=(const iterator& other) const { return _current.has_value() != other._current.has_value(); }
+      bool operator==(const iterator& other) const { return !(*this != other); }
+
+     private:
+      Searcher* _searcher = nullptr;
+      std::optional<PartResT> _current;
+    };
+
+    explicit LazyResults(Searcher* searcher) : _searcher(searcher) {}
+
+    iterator begin() { return iterator(_searcher, _searcher->lazy_next()); }
+    iterator end() { return iterator(); }
+
+   private:
+    Searcher* _searcher;
+  };
+
  public:  // --- public functions --------------------------------------------------------------------------------------
   Searcher(ReaderT&& reader, SearcherT&& searcher, int num_threads, int num_concurrent_reads = 1)
       : _reader(std::move(reader)),
@@ -38,7 +97,46 @@ class Searcher {
         _threads(num_threads),
         _read_semaphore(num_concurrent_reads) {}
 
-  ~Searcher() { join(); }
+  /**
+   * Pipelined Searcher (c.f. xs::Pipeline): num_threads search threads are fed by pipeline.num_io_threads reader
+   *  threads. Readers that are not ConcurrentReaderC are called by one reader thread at a time.
+   */
+  Searcher(ReaderT&& reader, SearcherT&& searcher, int num_threads, Pipeline pipeline)
+      : _reader(std::move(reader)),
+        _searcher(std::move(searcher)),
+        _threads(num_threads < 1 ? 1 : num_threads),
+        _io_threads(pipeline.num_io_threads < 1 ? 1 : pipeline.num_io_threads),
+        _read_semaphore(1),
+        _queue(std::make_unique<utils::RingQueue<std::optional<DataT>>>(pipeline.queue_capacity)) {}
+
+  /**
+   * Searcher running on a shared executor (e.g. utils::ThreadPool::global()) instead of its own threads: every chunk
+   *  is read and searched by a task of the pool, at most max_tasks (default: number of workers) at a time. Concurrent
+   *  searches interleave chunk by chunk on the workers of the pool.
+   *  Do not wait for the result from within a task of the same pool.
+   */
+  Searcher(ReaderT&& reader, SearcherT&& searcher, utils::ThreadPool& pool, int max_tasks = 0)
+      : _reader(std::move(reader)),
+        _searcher(std::move(searcher)),
+        _read_semaphore(1),
+        _pool(&pool),
+        _num_pool_tasks(max_tasks > 0 ? max_tasks : static_cast<int>(pool.num_workers())) {}
+
+  ~Searcher() {
+    if (_lazy_mode) {
+      // the consumer may have stopped early: do not read the rest of the input
+      std::unique_lock lock(_lazy.mutex);
+      _force_stop.store(true);
+      _lazy.cv.notify_all();
+      if (_pool != nullptr) {
+        _lazy.cv.wait(lock, [this]() { return _lazy.in_flight == 0; });
+      }
+    }
+    // errors of the search are only rethrown by join()
+    join_threads();
+    // the callback must not run on a destroyed Searcher
+    _stop_callback.reset();
+  }
 
   /// not copyable/movable
   Searcher(Searcher&&) = delete;
@@ -47,15 +145,12 @@ class Searcher {
   Searcher operator=(const Searcher&) = delete;
 
   /**
-   * Join all threads
+   * Join all threads. Rethrows the first exception thrown by the reader or the searcher during the search: the
+   *  search was stopped (c.f. cancelled()) and the result was closed when it occurred.
    */
   void join() {
-    for (auto& t : _threads) {
-      if (t.joinable()) {
-        t.join();
-      }
-    }
-    _is_running.store(false);
+    join_threads();
+    rethrow_error();
   }
 
   /**
@@ -65,25 +160,79 @@ class Searcher {
    *     Calling thread blocks until the searcher is done. const ResultT reference is returned.
    * (b) execute::async
    *     Searcher runs asynchronous. std::future<const ResultT&> is returned.
+   * (c) execute::live
+   *     Searcher runs asynchronous, std::future<ResultT&> is returned right away: the result can be iterated while the
+   *     search is running.
+   * (d) execute::lazy
+   *     Pull-driven: a LazyResults range is returned. Chunks are only read and searched as the range is iterated,
+   *     at most lookahead (default: number of threads) chunks ahead of the consumer. Partial results are yielded in
+   *     source order if the chunks carry sequence numbers (c.f. SequencedDataC). Stopping the iteration early (and
+   *     destroying the Searcher) leaves the rest of the input unread.
    */
   template <execute e = execute::blocking>
   auto execute() {
-    _is_running.store(true);
-    if constexpr (e == execute::async) {
-      return run_async();
-    } else if constexpr (e == execute::blocking) {
-      return run_blocking();
-    } else if constexpr (e == execute::live) {
-      auto res = run_live();
-      return res;
+    if constexpr (e == execute::lazy) {
+      return execute<e>(0);
+    } else {
+      _is_running.store(true);
+      if constexpr (e == execute::async) {
+        return run_async();
+      } else if constexpr (e == execute::blocking) {
+        return run_blocking();
+      } else if constexpr (e == execute::live) {
+        auto res = run_live();
+        return res;
+      }
     }
   }
 
+  /// lazy execution with at most lookahead chunks read ahead of the consumer (0: number of threads)
+  template <xs::execute e>
+    requires(e == xs::execute::lazy)
+  LazyResults execute(size_t lookahead) {
+    _is_running.store(true);
+    return run_lazy(lookahead);
+  }
+
   /**
    * Return if Searcher is running.
    */
   [[nodiscard]] bool running() const { return _is_running.load(); }
 
+  /**
+   * Cancel the search: no further chunks are read and chunks that were read already are dropped without being
+   *  searched. The result keeps the partial results found so far and is closed as usual.
+   */
+  void cancel() {
+    _force_stop.store(true);
+    // wake up a lazy consumer and lazy reader threads (c.f. execute::lazy)
+    std::unique_lock lock(_lazy.mutex);
+    _lazy.cv.notify_all();
+  }
+
+  /**
+   * Cancel the search once stop is requested on token, e.g. to stop several searches at once using a common
+   *  std::stop_source. Must be set before the Searcher is executed.
+   */
+  void set_stop_token(std::stop_token token) { _stop_callback.emplace(std::move(token), StopCallback{this}); }
+
+  /**
+   * Set a match budget: once max_count results (c.f. PartResT::size()) were found, no further chunks are read and
+   *  chunks that were read already are dropped without being searched (e.g. max_count = 1 for an existence check).
+   *  Chunks that are being searched at that time are completed: the result holds at least max_count results (if the
+   *  input has as many) but may hold more. Must be set before the Searcher is executed. 0: no limit (default).
+   */
+  void set_max_count(uint64_t max_count) {
+    _max_count = max_count;
+    _budget.store(static_cast<int64_t>(max_count));
+  }
+
+  /// return if the search was cancelled (c.f. cancel(), set_stop_token()) or failed (c.f. join())
+  [[nodiscard]] bool cancelled() const { return _force_stop.load(); }
+
+  /// return if the match budget was used up (c.f. set_max_count())
+  [[nodiscard]] bool budget_exhausted() const { return _budget_exhausted.load(); }
+
   /*
   template <typename T = ReaderT>
   requires InputStreamable<T>
@@ -97,25 +246,312 @@ class Searcher {
    */
 
  private:  // --- helper functions -------------------------------------------------------------------------------------
+  void join_threads() {
+    if (_pool != nullptr && !_lazy_mode) {
+      std::unique_lock lock(_pool_mutex);
+      _pool_cv.wait(lock, [this]() { return !_pool_tasks_started || _pool_tasks_done; });
+    }
+    for (auto& t : _io_threads) {
+      if (t.joinable()) {
+        t.join();
+      }
+    }
+    for (auto& t : _threads) {
+      if (t.joinable()) {
+        t.join();
+      }
+    }
+    _is_running.store(false);
+  }
+
+  /**
+   * Called by a worker whose reader or searcher threw: the first error is kept for join(), the search is stopped and
+   *  the result is closed (threads waiting for the chunk that failed, c.f. OrderedResult, are released).
+   */
+  void fail(std::exception_ptr error) {
+    {
+      std::unique_lock lock(_error_mutex);
+      if (!_error) {
+        _error = std::move(error);
+      }
+    }
+    cancel();
+    _result.close();
+  }
+
+  void rethrow_error() {
+    std::unique_lock lock(_error_mutex);
+    if (_error) {
+      std::rethrow_exception(_error);
+    }
+  }
+
+  std::optional<DataT> read() {
+    if constexpr (ConcurrentReaderC<ReaderT>) {
+      // the reader synchronizes itself: all threads read concurrently
+      return _reader();
+    } else {
+      return _read_semaphore.access([&]() { return _reader(); });
+    }
+  }
+
+  /// search data and hand it back to the reader
+  std::optional<PartResT> search_chunk(DataT& data) {
+    std::chrono::steady_clock::time_point search_begin;
+    if constexpr (FeedbackReaderC<ReaderT, DataT>) {
+      search_begin = std::chrono::steady_clock::now();
+    }
+    auto opt_result = _searcher(data);
+    if (_max_count > 0 && opt_result) {
+      int64_t num_results = 1;
+      if constexpr (requires { opt_result->size(); }) {
+        num_results = static_cast<int64_t>(opt_result->size());
+      }
+      if (num_results > 0 && _budget.fetch_sub(num_results) <= num_results) {
+        _budget_exhausted.store(true);
+      }
+    }
+    if constexpr (FeedbackReaderC<ReaderT, DataT>) {
+      size_t num_results = 0;
+      if constexpr (requires { opt_result->size(); }) {
+        num_results = opt_result ? opt_result->size() : 0;
+      }
+      _reader.feedback(data, std::chrono::steady_clock::now() - search_begin, num_results);
+    }
+    if constexpr (RecyclingReaderC<ReaderT, DataT>) {
+      // the chunk was searched: hand its buffer back to the reader
+      _reader.recycle(std::move(data));
+    }
+    return opt_result;
+  }
+
+  void search(DataT& data) {
+    if constexpr (OrderedResultC<ResultT, PartResT> && SequencedDataC<DataT>) {
+      uint64_t sequence_number = data.sequence_number();
+      _result.add(sequence_number, search_chunk(data));
+    } else {
+      auto opt_result = search_chunk(data);
+      if (opt_result) {
+        _result.add(std::move(opt_result.value()));
+      }
+    }
+  }
+
+  /// no further chunks are read once the search was cancelled or the match budget was used up
+  [[nodiscard]] bool stopped() const { return _force_stop.load() || _budget_exhausted.load(); }
+
+  /// drop a chunk that was read after the search was stopped
+  void discard(DataT& data) {
+    if constexpr (OrderedResultC<ResultT, PartResT> && SequencedDataC<DataT>) {
+      // fill the gap: later chunks may be waiting for this one
+      _result.add(data.sequence_number(), std::nullopt);
+    }
+    if constexpr (RecyclingReaderC<ReaderT, DataT>) {
+      _reader.recycle(std::move(data));
+    }
+  }
+
   void run_thread() {
-    atomic_fetch_add(&_threads_running, 1);
     while (true) {
-      if (_force_stop.load()) {
+      // pipelined: keep popping until the reader threads stopped, they may be blocked on a full queue
+      if (!_queue && stopped()) {
         break;
       }
-      auto opt_data = _read_semaphore.access([&]() { return _reader(); });
-      if (!opt_data) {
-        break;
+      try {
+        std::optional<DataT> opt_data = _queue ? _queue->pop() : read();
+        if (!opt_data) {
+          break;
+        }
+        if (stopped()) {
+          discard(opt_data.value());
+          continue;
+        }
+        search(opt_data.value());
+      } catch (...) {
+        fail(std::current_exception());
       }
-      auto opt_result = _searcher(opt_data.value());
-      if (opt_result) {
-        _result.add(std::move(opt_result.value()));
+    }
+    finish_thread();
+  }
+
+  /// one chunk of a task chain on the pool: the chain yields to the other tasks of the worker after every chunk
+  void run_pool_task() {
+    try {
+      std::optional<DataT> opt_data;
+      if (!stopped()) {
+        opt_data = read();
+      }
+      if (opt_data && stopped()) {
+        discard(opt_data.value());
+        opt_data.reset();
       }
+      if (!opt_data) {
+        finish_thread();
+        return;
+      }
+      search(opt_data.value());
+    } catch (...) {
+      fail(std::current_exception());
+      finish_thread();
+      return;
     }
-    atomic_fetch_sub(&_threads_running, 1);
-    if (_threads_running.load() == 0) {
+    _pool->yield([this]() { run_pool_task(); });
+  }
+
+  void finish_thread() {
+    if (_threads_running.fetch_sub(1) == 1) {
       _is_running.store(false);
       _result.close();
+      if (_pool != nullptr) {
+        std::unique_lock lock(_pool_mutex);
+        _pool_tasks_done = true;
+        _pool_cv.notify_all();
+      }
+    }
+  }
+
+  /// reader thread of the pipelined topology
+  void run_io_thread() {
+    while (!stopped()) {
+      std::optional<DataT> opt_data;
+      try {
+        opt_data = read();
+      } catch (...) {
+        fail(std::current_exception());
+        break;
+      }
+      if (!opt_data) {
+        break;
+      }
+      _queue->push(std::move(opt_data));
+    }
+    if (_io_threads_running.fetch_sub(1) == 1) {
+      // all chunks were queued: stop the search threads
+      for (size_t i = 0; i < _threads.size(); ++i) {
+        _queue->push(std::nullopt);
+      }
+    }
+  }
+
+  LazyResults run_lazy(size_t lookahead) {
+    _lazy_mode = true;
+    if (lookahead == 0) {
+      lookahead = _pool != nullptr ? static_cast<size_t>(_num_pool_tasks) : std::max<size_t>(1, _threads.size());
+    }
+    if (_pool != nullptr) {
+      std::unique_lock lock(_lazy.mutex);
+      for (size_t i = 0; i < lookahead; ++i) {
+        grant_lazy_chunk();
+      }
+    } else {
+      _lazy.tickets = lookahead;
+      for (auto& t : _threads) {
+        t = std::thread(&Searcher::run_lazy_thread, this);
+      }
+    }
+    return LazyResults(this);
+  }
+
+  /// allow one more chunk to be read (called with the lazy mutex held)
+  void grant_lazy_chunk() {
+    if (_lazy.exhausted) {
+      return;
+    }
+    if (_pool != nullptr) {
+      _lazy.in_flight++;
+      _pool->submit([this]() { lazy_step(); });
+    } else {
+      _lazy.tickets++;
+      _lazy.cv.notify_one();
+    }
+  }
+
+  void run_lazy_thread() {
+    while (true) {
+      {
+        std::unique_lock lock(_lazy.mutex);
+        _lazy.cv.wait(lock, [this]() { return _lazy.tickets > 0 || _lazy.exhausted || _force_stop.load(); });
+        if (_lazy.exhausted || _force_stop.load()) {
+          return;
+        }
+        _lazy.tickets--;
+        _lazy.in_flight++;
+      }
+      lazy_step();
+    }
+  }
+
+  /// read and search one chunk, store its partial result for the consumer
+  void lazy_step() {
+    std::optional<DataT> opt_data;
+    std::optional<PartResT> opt_result;
+    uint64_t sequence_number = 0;
+    try {
+      if (!stopped()) {
+        opt_data = read();
+      }
+      if (opt_data && stopped()) {
+        if constexpr (RecyclingReaderC<ReaderT, DataT>) {
+          _reader.recycle(std::move(opt_data.value()));
+        }
+        opt_data.reset();
+      }
+      if (opt_data) {
+        if constexpr (SequencedDataC<DataT>) {
+          sequence_number = opt_data->sequence_number();
+        }
+        opt_result = search_chunk(opt_data.value());
+      }
+    } catch (...) {
+      fail(std::current_exception());
+      opt_data.reset();
+    }
+    std::unique_lock lock(_lazy.mutex);
+    _lazy.in_flight--;
+    if (opt_data) {
+      if constexpr (!SequencedDataC<DataT>) {
+        // no sequence numbers: partial results are yielded in the order they are found
+        sequence_number = _lazy.next_arrival++;
+      }
+      _lazy.ready.emplace(sequence_number, std::move(opt_result));
+    } else {
+      _lazy.exhausted = true;
+    }
+    _lazy.cv.notify_all();
+  }
+
+  /// next non-empty partial result for the consumer, std::nullopt once all chunks were searched
+  std::optional<PartResT> lazy_next() {
+    std::unique_lock lock(_lazy.mutex);
+    while (true) {
+      _lazy.cv.wait(lock, [this]() {
+        bool reads_pending = _lazy.in_flight > 0 || (_lazy.tickets > 0 && !_lazy.exhausted);
+        return _lazy.ready.contains(_lazy.next) || !reads_pending || _force_stop.load();
+      });
+      rethrow_error();
+      auto it = _lazy.ready.find(_lazy.next);
+      if (it == _lazy.ready.end()) {
+        // next is not ready and no read is pending: the sequence numbers of the reader do not start at 0 or have a
+        // gap. Continue with the lowest ready one (all lookahead chunks may be waiting here).
+        if (_lazy.ready.empty() || _force_stop.load()) {
+          _is_running.store(false);
+          return {};
+        }
+        it = _lazy.ready.begin();
+      }
+      std::optional<PartResT> opt_result = std::move(it->second);
+      _lazy.next = it->first + 1;
+      _lazy.ready.erase(it);
+      grant_lazy_chunk();
+      if (!opt_result) {
+        continue;
+      }
+      if constexpr (requires { opt_result->empty(); }) {
+        if (opt_result->empty()) {
+          continue;
+        }
+      }
+      return opt_result;
     }
   }
 
@@ -139,6 +575,22 @@ class Searcher {
   }
 
   void run() {
+    if (_pool != nullptr) {
+      {
+        std::unique_lock lock(_pool_mutex);
+        _pool_tasks_started = true;
+      }
+      _threads_running.store(_num_pool_tasks);
+      for (int i = 0; i < _num_pool_tasks; ++i) {
+        _pool->submit([this]() { run_pool_task(); });
+      }
+      return;
+    }
+    _threads_running.store(static_cast<int>(_threads.size()));
+    _io_threads_running.store(static_cast<int>(_io_threads.size()));
+    for (auto& t : _io_threads) {
+      t = std::thread(&Searcher::run_io_thread, this);
+    }
     for (auto& t : _threads) {
       t = std::thread(&Searcher::run_thread, this);
     }
@@ -147,14 +599,61 @@ class Searcher {
  private:  // --- members ----------------------------------------------------------------------------------------------
   std::atomic<bool> _is_running = false;
   std::atomic<bool> _force_stop = false;
-  std::atomic<int> _threads_running;
+  std::atomic<bool> _budget_exhausted = false;
+  /// match budget, c.f. set_max_count()
+  uint64_t _max_count = 0;
+  std::atomic<int64_t> _budget = 0;
+
+  struct StopCallback {
+    Searcher* searcher;
+    void operator()() const { searcher->cancel(); }
+  };
+  std::optional<std::stop_callback<StopCallback>> _stop_callback;
+
+  /// first exception thrown by the reader or the searcher, c.f. fail()
+  std::exception_ptr _error;
+  std::mutex _error_mutex;
+  std::atomic<int> _threads_running = 0;
+  std::atomic<int> _io_threads_running = 0;
 
   ReaderT _reader;
   SearcherT _searcher;
   ResultT _result;
 
   std::vector<std::thread> _threads;
+  /// reader threads, only used by the pipelined topology
+  std::vector<std::thread> _io_threads;
   xs::utils::Semaphore _read_semaphore;
+  /// chunks read by the reader threads, nullptr unless pipelined
+  std::unique_ptr<utils::RingQueue<std::optional<DataT>>> _queue;
+
+  /// executor running the search, nullptr if the Searcher owns its threads
+  utils::ThreadPool* _pool = nullptr;
+  int _num_pool_tasks = 0;
+  std::mutex _pool_mutex;
+  std::condition_variable _pool_cv;
+  bool _pool_tasks_started = false;
+  bool _pool_tasks_done = false;
+
+  /// state of lazy execution, c.f. execute::lazy
+  struct LazyState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    /// chunks the threads may still read (thread mode)
+    size_t tickets = 0;
+    /// chunks being read and searched
+    size_t in_flight = 0;
+    /// the reader returned no more chunks
+    bool exhausted = false;
+    /// partial results by sequence number, waiting for the consumer
+    std::map<uint64_t, std::optional<PartResT>> ready;
+    /// sequence number of the next partial result handed to the consumer
+    uint64_t next = 0;
+    uint64_t next_arrival = 0;
+  };
+  /// created with the Searcher, so that cancel() can notify a lazy search from any thread
+  LazyState _lazy;
+  bool _lazy_mode = false;
 };
 
 }  // namespace xs
\ No newline at end of file
@@ -0,0 +1,79 @@
+/**
+ * Copyright 2023, Leon Freist (https://github.com/lfreist)
+ * Author: Leon Freist <freist.leon@gmail.com>
+ *
+ * This file is part of x-search.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace xs {
+
+/**
+ * Parallel gzip decompression without index (c.f. pugz, Kerbiriou and Chikhi 2019).
+ *
+ * The compressed data is split into num_chunks() parts of about chunk_size bytes. Chunk k starts with the first
+ *  (non-final, dynamic Huffman) deflate block found in its part, which is located by trying every bit offset and
+ *  validating the block header, the block and the header of the following block. Chunk k is inflated from there until
+ *  reaching the start of a following chunk, so that all chunks can be inflated concurrently.
+ *
+ * Back-references into the 32 KiB preceding a chunk cannot be resolved while inflating it: they are replaced by
+ *  placeholders (symbols >= 256, c.f. resolve()) that are resolved once the data preceding the chunk is known.
+ *
+ * The start of a chunk may be a false positive. In that case, the preceding chunk does not stop there (it continues
+ *  until the start of another chunk or the end of the data) and the chunk must be discarded: only the chunks reached
+ *  by following Chunk::next_chunk beginning at chunk 0 make up the data.
+ *
+ * Multi member gzip data is supported. All methods are thread safe.
+ */
+class SpeculativeInflater {
+ public:
+  /// inflated data of a chunk: symbols < 256 are bytes, others are placeholders
+  struct Chunk {
+    std::vector<uint16_t> symbols;
+    /// the chunk that starts where this one ends (num_chunks(): end of the data)
+    size_t next_chunk = 0;
+  };
+
+  /// data must remain valid while the inflater is used. Throws std::runtime_error if data is not gzip compressed
+  SpeculativeInflater(const char* data, size_t size, size_t chunk_size);
+
+  [[nodiscard]] size_t num_chunks() const { return _num_chunks; }
+
+  /**
+   * Inflate chunk k. Throws std::runtime_error if no deflate block was found for the chunk or the data is corrupted
+   *  (which may also be a consequence of a false positive block start).
+   */
+  Chunk inflate(size_t k) const;
+
+  /**
+   * Write size symbols to dest, replacing placeholders by the data they refer to. window holds the (up to 32 KiB)
+   *  bytes preceding the chunk. Throws std::runtime_error if a placeholder refers to data before window.
+   */
+  static void resolve(const uint16_t* symbols, size_t size, std::string_view window, char* dest);
+
+  /// maximal back-reference distance of deflate
+  static constexpr size_t window_size = 1 << 15;
+
+ private:
+  /// bit offset of the first deflate block of chunk k (located once, on first use)
+  std::optional<uint64_t> block_start(size_t k) const;
+  std::optional<uint64_t> find_block_start(size_t k) const;
+
+  const uint8_t* _data;
+  size_t _size;
+  size_t _num_chunks;
+  uint64_t _first_block = 0;
+
+  mutable std::unique_ptr<std::once_flag[]> _located;
+  mutable std::vector<std::optional<uint64_t>> _block_starts;
+};
+
+}  // namespace xs
@@ -0,0 +1,67 @@
+/**
+ * Copyright 2023, Leon Freist (https://github.com/lfreist)
+ * Author: Leon Freist <freist.leon@gmail.com>
+ *
+ * This file is part of x-search.
+ */
+
+#pragma once
+
+#include <xsearch/FileFormat.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace xs {
+
+/**
+ * Sequential access to the regular file members of a tar archive (ustar, GNU and PAX), read from the archive file
+ *  itself or decompressed on the fly (.tar.gz, .tar.zst, ... c.f. xs::StreamDecoder). Nothing is extracted: the
+ *  payload of the current member is read using read().
+ *
+ * Long member paths are taken from GNU long name ('L') and PAX ('x', path and size records) headers. Directories,
+ *  links and other non-regular members are skipped.
+ */
+class TarStream {
+ public:
+  struct Member {
+    std::string path;
+    uint64_t size = 0;
+  };
+
+  /// Throws std::runtime_error if the file cannot be opened
+  explicit TarStream(const std::string& path);
+  ~TarStream();
+
+  TarStream(const TarStream&) = delete;
+  TarStream& operator=(const TarStream&) = delete;
+
+  /**
+   * Skip the rest of the current member and advance to the next regular file member. Returns std::nullopt at the end
+   *  of the archive. Throws std::runtime_error if the archive is corrupted or truncated.
+   */
+  std::optional<Member> next_member();
+
+  /// read up to size bytes of the payload of the current member (less only at the end of the member)
+  size_t read(char* dest, size_t size);
+
+  /// number of payload bytes of the current member not read yet
+  [[nodiscard]] uint64_t remaining() const { return _remaining; }
+
+ private:
+  /// read exactly size bytes of the archive (less only at its end)
+  size_t read_archive(char* dest, size_t size);
+  void skip(uint64_t size);
+  /// the payload of the current (meta data) member
+  std::string read_payload(uint64_t size);
+
+  int _fd = -1;
+  std::unique_ptr<StreamDecoder> _decoder;
+  uint64_t _remaining = 0;
+  uint64_t _padding = 0;
+  bool _done = false;
+};
+
+}  // namespace xs
@@ -7,25 +7,103 @@
 
 #pragma once
 
+#include <chrono>
 #include <concepts>
+#include <cstdint>
 #include <iostream>
 #include <optional>
+#include <utility>
 #include <vector>
 
 namespace xs {
 
+/**
+ * Any contiguous chunk of data that can be searched: owning buffers (e.g. xs::strtype) as well as non-owning views
+ * (e.g. xs::DataView).
+ */
 template <typename DefaultDataT>
-concept DefaultDataC = requires(DefaultDataT data, size_t size) {
+concept DefaultDataC = requires(const DefaultDataT data) {
   { std::is_default_constructible_v<DefaultDataT> };
+  { data.data() } -> std::convertible_to<const char*>;
+  { data.size() } -> std::convertible_to<size_t>;
+};
+
+/**
+ * Owning, resizable chunk of data that a reader can write into.
+ */
+template <typename DataT>
+concept ResizableDataC = DefaultDataC<DataT> && requires(DataT data, size_t size) {
   { data.resize(size) };
   { data.data() } -> std::convertible_to<char*>;
 };
 
+/**
+ * Chunk of data that knows its byte offset within the source it was read from.
+ */
+template <typename DataT>
+concept OffsetDataC = DefaultDataC<DataT> && requires(const DataT data) {
+  { data.offset() } -> std::convertible_to<uint64_t>;
+};
+
+/**
+ * Chunk of data whose offset can be set by the reader that fills it.
+ */
+template <typename DataT>
+concept MutableOffsetDataC = OffsetDataC<DataT> && requires(DataT data, uint64_t offset) {
+  { data.set_offset(offset) };
+};
+
+/**
+ * Chunk of data that knows its position within the sequence of chunks read from its source (c.f.
+ *  xs::BasicDataChunk::sequence_number()).
+ */
+template <typename DataT>
+concept SequencedDataC = DefaultDataC<DataT> && requires(const DataT data) {
+  { data.sequence_number() } -> std::convertible_to<uint64_t>;
+};
+
+/**
+ * Chunk of data whose sequence number can be set by the reader that fills it.
+ */
+template <typename DataT>
+concept MutableSequencedDataC = SequencedDataC<DataT> && requires(DataT data, uint64_t sequence_number) {
+  { data.set_sequence_number(sequence_number) };
+};
+
 template <typename Task, typename DataT>
-concept ReaderC = std::is_move_constructible_v<Task> && requires(Task task) {
+concept ReaderC = std::is_move_constructible_v<Task> && DefaultDataC<DataT> && requires(Task task) {
   { task() } -> std::same_as<std::optional<DataT>>;
 };
 
+/**
+ * Reader that takes chunks back once they were searched and reuses their memory for subsequent chunks: the buffers
+ *  of recycled chunks are pooled (up to a limit, c.f. utils::BufferPool) and handed out again by the next reads.
+ *  Recycling is optional, a chunk that is not recycled is simply freed. A chunk must not be used after it was
+ *  recycled.
+ */
+template <typename Task, typename DataT>
+concept RecyclingReaderC = ReaderC<Task, DataT> && requires(Task task, DataT data) {
+  { task.recycle(std::move(data)) };
+};
+
+/**
+ * Reader that wants to know how long its chunks took to search and how many results they produced (e.g. to adapt its
+ *  chunk size, c.f. xs::FileReader::autotune()). Called by the search threads concurrently.
+ */
+template <typename Task, typename DataT>
+concept FeedbackReaderC = ReaderC<Task, DataT> && requires(Task task, const DataT& data, size_t num_results) {
+  { task.feedback(data, std::chrono::nanoseconds(), num_results) };
+};
+
+/**
+ * Reader that may be called by multiple threads at the same time (declared by a static constexpr bool member
+ *  concurrent_access = true). xs::Searcher does not serialize calls of such readers.
+ */
+template <typename Task>
+concept ConcurrentReaderC = requires {
+  requires Task::concurrent_access;
+};
+
 template <typename Res, typename PartRes>
 concept ResultC = requires(Res result, PartRes& partial_result) {
   { result.add(partial_result) };
@@ -33,6 +111,16 @@ concept ResultC = requires(Res result, PartRes& partial_result) {
   { result.close() };
 };
 
+/**
+ * Result that puts partial results into the order of the sequence numbers of their chunks (c.f. xs::OrderedResult).
+ *  Chunks without partial result are announced using std::nullopt, so that no gaps remain.
+ */
+template <typename Res, typename PartRes>
+concept OrderedResultC = ResultC<Res, PartRes> && requires(Res result, uint64_t sequence_number,
+                                                           std::optional<PartRes> partial_result) {
+  { result.add(sequence_number, std::move(partial_result)) };
+};
+
 template <typename Task, typename PartRes, typename DataT>
 concept SearcherC = std::is_move_constructible_v<Task> && requires(Task task, const DataT& data) {
   { task(data) } -> std::same_as<std::optional<PartRes>>;
@@ -148,7 +148,7 @@ std::vector<uint64_t> byte_offsets_match(const T& data, const std::string& patte
  */
 template <DefaultDataC T>
 std::vector<uint64_t> byte_offsets_line(const T& data, const std::string& pattern) {
-  return _byte_offsets(data, pattern, true, [data](uint64_t v) {
+  return _byte_offsets(data, pattern, true, [&data](uint64_t v) {
     return v - previous_new_line_offset_relative_to_match(data, v);
   });
 }
@@ -218,7 +218,7 @@ namespace regex {
  */
 template <DefaultDataC T>
 std::vector<uint64_t> byte_offsets_line(const T& data, const re2::RE2& pattern) {
-  return _regex_byte_offsets(data, pattern, true, [data](uint64_t v) {
+  return _regex_byte_offsets(data, pattern, true, [&data](uint64_t v) {
     return v - previous_new_line_offset_relative_to_match(data, v);
   });
 }
@@ -21,6 +21,18 @@ namespace xs::search::simd {
  */
 const char* strchr(const char* str, size_t str_len, char c);
 
+/**
+ * std::strrchr implementation using simd instruction set (AVX): str is scanned
+ * backwards, starting at its end. Like simd::strchr, the size of str must be
+ * provided.
+ *
+ * @param str data string
+ * @param str_len size of str
+ * @param c char to be searched for in str
+ * @return pointer to the last occurrence of c in str or nullptr
+ */
+const char* strrchr(const char* str, size_t str_len, char c);
+
 /**
  * std::strstr implementation using simd instruction set (AVX). Additionally to
  * the std::strchr specification, the size of str and pattern must be provided
@@ -63,6 +75,16 @@ int64_t findNext(const char* pattern, size_t pattern_len, const char* str, size_
  */
 int64_t findNextNewLine(const char* str, size_t str_len, size_t shift);
 
+/**
+ * simd::strrchr wrapper for getting the offset of the last new line char (\n)
+ * with respect to the start of str.
+ *
+ * @param str data string
+ * @param str_len size of str
+ * @return offset of the last new line char or -1 if str contains none
+ */
+int64_t findLastNewLine(const char* str, size_t str_len);
+
 /**
  * Counts the occurrences of pattern in str, moving to next new line char (\n)
  * whenever a match was found -> Count the occurrences of pattern in str per
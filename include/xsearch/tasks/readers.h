@@ -7,13 +7,51 @@
 
 #pragma once
 
+#include <xsearch/FileFormat.h>
+#include <xsearch/GzipIndex.h>
+#include <xsearch/MetaFile.h>
+#include <xsearch/SpeculativeInflater.h>
+#include <xsearch/TarStream.h>
 #include <xsearch/concepts.h>
+#include <xsearch/string_search/simd_search.h>
 #include <xsearch/types.h>
+#include <xsearch/utils/BufferPool.h>
+#include <xsearch/utils/ChunkSizeTuner.h>
+#include <xsearch/utils/IoUring.h>
+#include <xsearch/utils/ReadAhead.h>
+#include <xsearch/utils/file_utils.h>
 
+#include <fcntl.h>
+#include <lz4.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zstd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
 #include <fstream>
 #include <istream>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
 
 namespace xs {
 
@@ -26,31 +64,2271 @@ class Reader_I {
   virtual std::optional<T> operator()() = 0;
 };
 
-template <DefaultDataC T = xs::strtype>
+/**
+ * Store the position of a chunk within the sequence of chunks of its source in the chunk, if T supports it (c.f.
+ *  xs::BasicDataChunk::sequence_number()). Readers number their chunks without gaps: a claimed chunk that turns out
+ *  to be empty is returned anyway.
+ */
+template <typename T>
+void _set_sequence_number(T& data, uint64_t sequence_number) {
+  if constexpr (MutableSequencedDataC<T>) {
+    data.set_sequence_number(sequence_number);
+  }
+}
+
+/**
+ * Fill data with the next newline-aligned chunk of a sequential input: data starts with the tail (partial line) left
+ *  over from the previous chunk followed by freshly read bytes and ends with the last new line char found. The
+ *  bytes behind it are moved into tail. If no new line char is found, the chunk grows until one is found or the input
+ *  ends. The last chunk ends with the input.
+ *
+ * @param read - read(char* dest, size_t size) reads up to size bytes, returning less only at the end of the input
+ */
+template <ResizableDataC T, typename ReadF>
+  requires std::is_invocable_r_v<size_t, ReadF, char*, size_t>
+void _fill_newline_aligned(T& data, T& tail, size_t chunk_size, ReadF read) {
+  size_t size = tail.size();
+  // the tail is part of the chunk: chunks (and thus pooled buffers) do not exceed chunk_size unless a line does
+  data.resize(size < chunk_size ? chunk_size : size + chunk_size);
+  std::memcpy(data.data(), tail.data(), size);
+  tail.resize(0);
+  while (true) {
+    // the carried over tail does not contain a new line char: only the freshly read bytes need to be searched
+    size_t read_begin = size;
+    size_t requested = data.size() - size;
+    size += read(data.data() + size, requested);
+    if (size - read_begin < requested) {
+      // the last chunk ends with the input
+      break;
+    }
+    int64_t last_new_line = search::simd::findLastNewLine(data.data() + read_begin, size - read_begin);
+    if (last_new_line != -1) {
+      auto chunk_end = static_cast<size_t>(read_begin + last_new_line + 1);
+      tail.resize(size - chunk_end);
+      std::memcpy(tail.data(), data.data() + chunk_end, size - chunk_end);
+      data.resize(chunk_end);
+      return;
+    }
+    // no new line char within the whole chunk: grow it until we find one
+    data.resize(size + chunk_size);
+  }
+  data.resize(size);
+}
+
+/**
+ * pread() size bytes of fd starting at offset into dest. Short reads are continued, so that less than size bytes are
+ *  read only if the file ends earlier. Throws std::runtime_error if reading fails.
+ *
+ * @return number of bytes read
+ */
+inline size_t _pread_all(int fd, char* dest, size_t size, uint64_t offset, const std::string& file_path) {
+  size_t total = 0;
+  while (total < size) {
+    ssize_t num_bytes = ::pread(fd, dest + total, size - total, static_cast<off_t>(offset + total));
+    if (num_bytes == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error("cannot read '" + file_path + "': " + std::strerror(errno));
+    }
+    if (num_bytes == 0) {
+      break;
+    }
+    total += static_cast<size_t>(num_bytes);
+  }
+  return total;
+}
+
+/**
+ * Offset of the first line of fd starting at or after pos: the offset behind the first '\n' at or after pos - 1
+ *  (or file_size, if there is none). Used to move chunk boundaries of positional readers to line boundaries: both
+ *  chunks adjacent to a boundary compute the same line begin independently.
+ *
+ * At most max_scan bytes (starting at pos - 1) are searched: std::nullopt is returned if they do not contain a '\n'
+ *  and the file continues behind them.
+ */
+inline std::optional<uint64_t> _line_begin(int fd, uint64_t pos, uint64_t file_size, const std::string& file_path,
+                                           uint64_t max_scan = std::numeric_limits<uint64_t>::max()) {
+  if (pos == 0 || pos >= file_size) {
+    return std::min(pos, file_size);
+  }
+  char buffer[4096];
+  pos--;
+  uint64_t scan_end = file_size - pos > max_scan ? pos + max_scan : file_size;
+  while (pos < scan_end) {
+    size_t num_bytes = _pread_all(fd, buffer, std::min<uint64_t>(sizeof(buffer), scan_end - pos), pos, file_path);
+    if (num_bytes == 0) {
+      return file_size;
+    }
+    const char* new_line = search::simd::strchr(buffer, num_bytes, '\n');
+    if (new_line != nullptr) {
+      return pos + (new_line - buffer) + 1;
+    }
+    pos += num_bytes;
+  }
+  if (scan_end < file_size) {
+    return std::nullopt;
+  }
+  return file_size;
+}
+
+/**
+ * Line aligned bounds of the chunk [begin, begin + chunk_size) of fd, c.f. PReadFileReader: the chunk starts behind
+ *  the first '\n' at or after begin - 1 and ends behind the first '\n' at or after begin + chunk_size - 1. The
+ *  search for the chunk begin is bounded by chunk_size bytes: if they do not contain a '\n', the chunk lies within a
+ *  line that is owned by a previous chunk and the empty range {begin, begin} is returned. Only the owning chunk
+ *  searches the line for its end, so that long lines (or files without new line chars) are scanned once instead of
+ *  once per chunk.
+ */
+inline std::pair<uint64_t, uint64_t> _line_aligned_range(int fd, uint64_t begin, uint64_t chunk_size,
+                                                         uint64_t file_size, const std::string& file_path) {
+  auto line_begin = _line_begin(fd, begin, file_size, file_path, chunk_size);
+  if (!line_begin) {
+    return {begin, begin};
+  }
+  uint64_t end = begin + chunk_size;
+  if (end >= file_size) {
+    return {*line_begin, file_size};
+  }
+  return {*line_begin, *_line_begin(fd, end, file_size, file_path)};
+}
+
+/**
+ * Reads a file chunk by chunk using an std::ifstream.
+ *  Chunk buffers are taken from a bounded pool. Chunks given back using recycle() are reused, so that a steady-state
+ *  scan does not allocate (nor, using xs::strtype, zero) any chunk memory.
+ *
+ * If align_to_newline is set, every chunk ends with the last new line char ('\n') that falls into it: the partial
+ *  line following it is carried over (copied in memory, not re-read) to the front of the next chunk. Lines are never
+ *  split between two chunks, so every chunk can be searched independently. A chunk is grown beyond chunk_size if it
+ *  does not contain any new line char at all. The last chunk ends wherever the file ends.
+ *
+ * If max_read_ahead > 0, an adaptive window of up to max_read_ahead upcoming chunks is prefetched into the page cache
+ *  while the current chunks are searched (c.f. utils::ReadAhead).
+ *
+ * The chunk size can be adapted to the storage, the pattern and the number of threads while reading (c.f. autotune()).
+ */
+template <ResizableDataC T = xs::strtype>
 class FileReader : Reader_I<T> {
  public:
-  explicit FileReader(std::string file_path, size_t chunk_size = 524288)
-      : _file_path(std::move(file_path)), _fstream(_file_path), _chunk_size(chunk_size) {}
+  explicit FileReader(std::string file_path, size_t chunk_size = 524288, bool align_to_newline = false,
+                      size_t max_pooled_buffers = 64, size_t max_read_ahead = 0)
+      : _chunk_size(chunk_size),
+        _align_to_newline(align_to_newline),
+        _file_path(std::move(file_path)),
+        _fstream(_file_path),
+        _buffer_pool(max_pooled_buffers) {
+    if (max_read_ahead > 0) {
+      _read_ahead = std::make_unique<utils::ReadAhead>(_file_path, _chunk_size, max_read_ahead);
+    }
+  }
   ~FileReader() { _fstream.close(); }
 
   FileReader(FileReader&&) = default;
   FileReader& operator=(FileReader&&) = default;
 
   std::optional<T> operator()() override {
-    if (_fstream.eof()) {
+    if (_tuner == nullptr) {
+      return read_chunk();
+    }
+    _chunk_size = _tuner->chunk_size();
+    if (_read_ahead != nullptr) {
+      _read_ahead->set_chunk_size(_chunk_size);
+    }
+    auto begin = std::chrono::steady_clock::now();
+    auto data = read_chunk();
+    if (data) {
+      _tuner->record_read(data->size(), std::chrono::steady_clock::now() - begin);
+    }
+    return data;
+  }
+
+  void recycle(T&& data) { _buffer_pool.release(std::move(data)); }
+
+  /**
+   * Adapt the chunk size while the file is read (c.f. utils::ChunkSizeTuner): read latencies are measured by the
+   *  reader, search times and result counts are reported by xs::Searcher through feedback(). The chunk size passed to
+   *  the constructor is the starting point. max_chunk_size is further limited so that every one of num_threads
+   *  threads gets at least four chunks of the file.
+   *
+   * @return the tuner: provides the current chunk size and the history of the tuning, also after the reader was moved
+   *  into an xs::Searcher
+   */
+  std::shared_ptr<const utils::ChunkSizeTuner> autotune(size_t num_threads, size_t min_chunk_size = 1 << 16,
+                                                        size_t max_chunk_size = 1 << 24) {
+    std::error_code ec;
+    uint64_t file_size = std::filesystem::file_size(_file_path, ec);
+    if (!ec) {
+      max_chunk_size = std::min<uint64_t>(max_chunk_size, file_size / (std::max<size_t>(1, num_threads) * 4));
+    }
+    max_chunk_size = std::max(min_chunk_size, max_chunk_size);
+    _tuner = std::make_shared<utils::ChunkSizeTuner>(_chunk_size, num_threads, min_chunk_size, max_chunk_size);
+    return _tuner;
+  }
+
+  /// called by xs::Searcher once data was searched
+  void feedback(const T& data, std::chrono::nanoseconds search_time, size_t num_results) {
+    if (_tuner != nullptr) {
+      _tuner->record_search(data.size(), search_time, num_results);
+    }
+  }
+
+  /// current read-ahead window in chunks (0 if read-ahead is disabled)
+  [[nodiscard]] size_t read_ahead_window() const { return _read_ahead == nullptr ? 0 : _read_ahead->window(); }
+
+ private:
+  std::optional<T> read_chunk() {
+    if (_align_to_newline) {
+      return read_newline_aligned();
+    }
+    if (_fstream.eof() || !_fstream.is_open()) {
       return {};
     }
-    T data;
+    T data = _buffer_pool.acquire();
     data.resize(_chunk_size);
-    _fstream.read(data.data(), _chunk_size);
-    data.resize(_fstream.gcount());
+    data.resize(read(data.data(), _chunk_size));
+    if (data.size() == 0) {
+      _buffer_pool.release(std::move(data));
+      return {};
+    }
+    set_position(data);
     return std::make_optional(std::move(data));
   }
 
- private:
+  size_t read(char* dest, size_t size) {
+    if (_read_ahead != nullptr) {
+      _read_ahead->before_read(_stream_offset, size);
+    }
+    _fstream.read(dest, static_cast<std::streamsize>(size));
+    auto num_bytes = static_cast<size_t>(_fstream.gcount());
+    if (_read_ahead != nullptr) {
+      _read_ahead->after_read();
+    }
+    _stream_offset += num_bytes;
+    return num_bytes;
+  }
+
+  std::optional<T> read_newline_aligned() {
+    if ((_fstream.eof() || !_fstream.is_open()) && _tail.size() == 0) {
+      return {};
+    }
+    T data = _buffer_pool.acquire();
+    _fill_newline_aligned(data, _tail, _chunk_size, [this](char* dest, size_t size) { return read(dest, size); });
+    if (data.size() == 0) {
+      _buffer_pool.release(std::move(data));
+      return {};
+    }
+    set_position(data);
+    return std::make_optional(std::move(data));
+  }
+
+  /// store the offset and the sequence number of the next chunk in data
+  void set_position(T& data) {
+    if constexpr (MutableOffsetDataC<T>) {
+      data.set_offset(_offset);
+    }
+    _offset += data.size();
+    _set_sequence_number(data, _sequence_number++);
+  }
+
   size_t _chunk_size;
+  bool _align_to_newline;
   std::string _file_path;
   std::ifstream _fstream;
+  /// partial line at the end of the previously read chunk
+  T _tail;
+  /// offset of the next chunk within the file
+  uint64_t _offset = 0;
+  uint64_t _sequence_number = 0;
+  /// number of bytes read from _fstream
+  uint64_t _stream_offset = 0;
+  utils::BufferPool<T> _buffer_pool;
+  std::unique_ptr<utils::ReadAhead> _read_ahead;
+  std::shared_ptr<utils::ChunkSizeTuner> _tuner;
+};
+
+/**
+ * Reads from a stream file descriptor (stdin, a pipe, a socket, ...) that can neither be mapped nor read at arbitrary
+ *  offsets. Chunks are filled by read() directly into pooled buffers (short reads are continued until the chunk is
+ *  full or the stream ends) and are newline-aligned by default, so that xs::Searcher can search them in parallel.
+ *  Pipes are enlarged to chunk_size (F_SETPIPE_SZ) so that the writer is not throttled by the default 64 KiB pipe.
+ *
+ * The file descriptor is not owned (and not closed) by the reader.
+ */
+template <ResizableDataC T = xs::DataChunk>
+class StreamReader : Reader_I<T> {
+ public:
+  explicit StreamReader(int fd = STDIN_FILENO, size_t chunk_size = 524288, bool align_to_newline = true,
+                        size_t max_pooled_buffers = 64)
+      : _fd(fd), _chunk_size(chunk_size), _align_to_newline(align_to_newline), _buffer_pool(max_pooled_buffers) {
+    struct stat st {};
+    if (::fstat(_fd, &st) == -1) {
+      throw std::runtime_error(std::string("StreamReader: invalid file descriptor: ") + std::strerror(errno));
+    }
+    if (S_ISFIFO(st.st_mode)) {
+      // may fail if chunk_size exceeds /proc/sys/fs/pipe-max-size for unprivileged users: keep the default then
+      ::fcntl(_fd, F_SETPIPE_SZ, static_cast<int>(std::min<size_t>(_chunk_size, 1 << 20)));
+    }
+  }
+
+  StreamReader(StreamReader&&) noexcept = default;
+  StreamReader& operator=(StreamReader&&) noexcept = default;
+
+  std::optional<T> operator()() override {
+    if (_eof && _tail.size() == 0) {
+      return {};
+    }
+    T data = _buffer_pool.acquire();
+    auto read_func = [this](char* dest, size_t size) { return read(dest, size); };
+    if (_align_to_newline) {
+      _fill_newline_aligned(data, _tail, _chunk_size, read_func);
+    } else {
+      data.resize(_chunk_size);
+      data.resize(read(data.data(), _chunk_size));
+    }
+    if (data.size() == 0) {
+      _buffer_pool.release(std::move(data));
+      return {};
+    }
+    if constexpr (MutableOffsetDataC<T>) {
+      data.set_offset(_offset);
+    }
+    _offset += data.size();
+    _set_sequence_number(data, _sequence_number++);
+    return std::make_optional(std::move(data));
+  }
+
+  void recycle(T&& data) { _buffer_pool.release(std::move(data)); }
+
+ private:
+  /// read until size bytes were read or the stream ended
+  size_t read(char* dest, size_t size) {
+    size_t total = 0;
+    while (total < size && !_eof) {
+      ssize_t num_bytes = ::read(_fd, dest + total, size - total);
+      if (num_bytes == -1) {
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          // non-blocking descriptor: wait for data
+          pollfd pfd{_fd, POLLIN, 0};
+          ::poll(&pfd, 1, -1);
+          continue;
+        }
+        throw std::runtime_error(std::string("StreamReader: cannot read: ") + std::strerror(errno));
+      }
+      if (num_bytes == 0) {
+        _eof = true;
+        break;
+      }
+      total += static_cast<size_t>(num_bytes);
+    }
+    return total;
+  }
+
+  int _fd;
+  size_t _chunk_size;
+  bool _align_to_newline;
+  bool _eof = false;
+  /// number of bytes handed out so far (offset of the next chunk)
+  uint64_t _offset = 0;
+  uint64_t _sequence_number = 0;
+  /// partial line at the end of the previously read chunk
+  T _tail;
+  utils::BufferPool<T> _buffer_pool;
+};
+
+/**
+ * Zero-copy reader: the file is memory mapped and the reader hands out non-owning views (pointer, size and global
+ *  byte offset) on consecutive chunks of the mapping. No data is copied and no chunk buffers are allocated.
+ *
+ * The next chunk is claimed using an atomic cursor, so the reader may be called by multiple threads concurrently.
+ *  The returned views are valid as long as the reader is alive.
+ *
+ * @tparam T - non-owning view type, constructible from (const char* data, size_t size, uint64_t offset)
+ */
+template <DefaultDataC T = xs::DataView>
+  requires std::constructible_from<T, const char*, size_t, uint64_t>
+class MmapFileReader : Reader_I<T> {
+ public:
+  static constexpr bool concurrent_access = true;
+
+  explicit MmapFileReader(std::string file_path, size_t chunk_size = 524288)
+      : _chunk_size(chunk_size), _file_path(std::move(file_path)) {
+    int fd = ::open(_file_path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      throw std::runtime_error("MmapFileReader: cannot open '" + _file_path + "': " + std::strerror(errno));
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) == -1) {
+      ::close(fd);
+      throw std::runtime_error("MmapFileReader: cannot stat '" + _file_path + "': " + std::strerror(errno));
+    }
+    _size = static_cast<size_t>(st.st_size);
+    if (_size > 0) {
+      void* addr = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("MmapFileReader: cannot map '" + _file_path + "': " + std::strerror(errno));
+      }
+      _data = static_cast<const char*>(addr);
+      // chunks are handed out front to back: let the kernel read ahead aggressively and drop pages behind
+      ::madvise(const_cast<char*>(_data), _size, MADV_SEQUENTIAL);
+      ::madvise(const_cast<char*>(_data), std::min(_chunk_size, _size), MADV_WILLNEED);
+    }
+    // the mapping stays valid after the file descriptor is closed
+    ::close(fd);
+  }
+
+  ~MmapFileReader() {
+    if (_data != nullptr) {
+      ::munmap(const_cast<char*>(_data), _size);
+    }
+  }
+
+  /// not copyable
+  MmapFileReader(const MmapFileReader&) = delete;
+  MmapFileReader& operator=(const MmapFileReader&) = delete;
+
+  /// movable: the mapping is handed over to the new reader
+  MmapFileReader(MmapFileReader&& other) noexcept
+      : _chunk_size(other._chunk_size),
+        _file_path(std::move(other._file_path)),
+        _data(std::exchange(other._data, nullptr)),
+        _size(std::exchange(other._size, 0)),
+        _offset(other._offset.load()) {}
+  MmapFileReader& operator=(MmapFileReader&&) = delete;
+
+  std::optional<T> operator()() override {
+    uint64_t offset = _offset.fetch_add(_chunk_size);
+    if (offset >= _size) {
+      return {};
+    }
+    size_t size = std::min(_chunk_size, _size - offset);
+    // request the chunk following this one while this one is searched
+    if (offset + size < _size) {
+      will_need(offset + size, std::min(_chunk_size, _size - offset - size));
+    }
+    if constexpr (std::constructible_from<T, const char*, size_t, uint64_t, uint64_t>) {
+      return std::make_optional<T>(_data + offset, size, offset, offset / _chunk_size);
+    } else {
+      return std::make_optional<T>(_data + offset, size, offset);
+    }
+  }
+
+  /// size of the mapped file in bytes
+  [[nodiscard]] size_t size() const { return _size; }
+
+ private:
+  void will_need(uint64_t offset, size_t size) const {
+    static const auto page_size = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+    uint64_t aligned_offset = offset - (offset % page_size);
+    ::madvise(const_cast<char*>(_data + aligned_offset), size + (offset - aligned_offset), MADV_WILLNEED);
+  }
+
+  size_t _chunk_size;
+  std::string _file_path;
+  const char* _data = nullptr;
+  size_t _size = 0;
+  std::atomic<uint64_t> _offset{0};
+};
+
+/**
+ * Parallel positional reader: chunks are assigned to the calling threads using an atomic chunk index and every thread
+ *  reads its own byte range using pread(). N threads calling the reader issue N concurrent reads, xs::Searcher does
+ *  not serialize them (c.f. ConcurrentReaderC).
+ *
+ * If align_to_newline is set, the chunk boundaries are moved behind the next new line char: chunk k starts behind the
+ *  first '\n' at or after byte k * chunk_size - 1 and ends behind the first '\n' at or after byte
+ *  (k + 1) * chunk_size - 1. Both neighbours of a boundary compute it the same way, so no line is split or read twice
+ *  while every chunk is still read independently.
+ *
+ * Chunk buffers are pooled like in xs::FileReader. Global offsets are stored in the chunks if T provides set_offset().
+ */
+template <ResizableDataC T = xs::DataChunk>
+class PReadFileReader : Reader_I<T> {
+ public:
+  static constexpr bool concurrent_access = true;
+
+  explicit PReadFileReader(std::string file_path, size_t chunk_size = 524288, bool align_to_newline = false,
+                           size_t max_pooled_buffers = 64)
+      : _chunk_size(chunk_size),
+        _align_to_newline(align_to_newline),
+        _file_path(std::move(file_path)),
+        _buffer_pool(max_pooled_buffers) {
+    _fd = ::open(_file_path.c_str(), O_RDONLY);
+    if (_fd == -1) {
+      throw std::runtime_error("PReadFileReader: cannot open '" + _file_path + "': " + std::strerror(errno));
+    }
+    struct stat st {};
+    if (::fstat(_fd, &st) == -1) {
+      ::close(_fd);
+      throw std::runtime_error("PReadFileReader: cannot stat '" + _file_path + "': " + std::strerror(errno));
+    }
+    _size = static_cast<uint64_t>(st.st_size);
+    ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  }
+
+  ~PReadFileReader() {
+    if (_fd != -1) {
+      ::close(_fd);
+    }
+  }
+
+  /// not copyable
+  PReadFileReader(const PReadFileReader&) = delete;
+  PReadFileReader& operator=(const PReadFileReader&) = delete;
+
+  /// movable: the file descriptor is handed over to the new reader
+  PReadFileReader(PReadFileReader&& other) noexcept
+      : _chunk_size(other._chunk_size),
+        _align_to_newline(other._align_to_newline),
+        _file_path(std::move(other._file_path)),
+        _fd(std::exchange(other._fd, -1)),
+        _size(other._size),
+        _next_chunk_index(other._next_chunk_index.load()),
+        _buffer_pool(std::move(other._buffer_pool)) {}
+  PReadFileReader& operator=(PReadFileReader&&) = delete;
+
+  std::optional<T> operator()() override {
+    uint64_t index = _next_chunk_index.fetch_add(1);
+    uint64_t begin = index * _chunk_size;
+    if (begin >= _size) {
+      return {};
+    }
+    uint64_t end = std::min(begin + _chunk_size, _size);
+    if (_align_to_newline) {
+      // begin == end if the whole chunk is part of a line that was started (and is read) by a previous chunk: the
+      //  empty chunk is returned anyway to keep the sequence numbers gapless
+      std::tie(begin, end) = _line_aligned_range(_fd, begin, _chunk_size, _size, _file_path);
+    }
+    T data = _buffer_pool.acquire();
+    data.resize(end - begin);
+    _pread_all(_fd, data.data(), end - begin, begin, _file_path);
+    if constexpr (MutableOffsetDataC<T>) {
+      data.set_offset(begin);
+    }
+    _set_sequence_number(data, index);
+    return std::make_optional(std::move(data));
+  }
+
+  void recycle(T&& data) { _buffer_pool.release(std::move(data)); }
+
+  /// size of the file in bytes
+  [[nodiscard]] uint64_t size() const { return _size; }
+
+ private:
+  size_t _chunk_size;
+  bool _align_to_newline;
+  std::string _file_path;
+  int _fd = -1;
+  uint64_t _size = 0;
+  std::atomic<uint64_t> _next_chunk_index{0};
+  utils::BufferPool<T> _buffer_pool;
+};
+
+/**
+ * Asynchronous reader using io_uring: up to queue_depth chunk reads are kept in flight in the submission ring, and
+ *  completed chunks are handed to the calling threads in the order they complete. The I/O depth is thereby
+ *  independent of the number of threads searching the chunks.
+ *
+ * Chunks are returned out of order, T should provide set_offset() (c.f. xs::DataChunk) for global offsets.
+ *  If io_uring is not available (old kernel, disabled by seccomp, ...), xs::FileReader is used instead.
+ */
+template <ResizableDataC T = xs::DataChunk>
+class IoUringReader : Reader_I<T> {
+  struct Request {
+    T data;
+    uint64_t offset = 0;
+    size_t size = 0;
+    /// number of bytes already read (reads may complete partially)
+    size_t done = 0;
+  };
+
+ public:
+  /// the ring is synchronized internally
+  static constexpr bool concurrent_access = true;
+
+  explicit IoUringReader(std::string file_path, size_t chunk_size = 524288, unsigned queue_depth = 32,
+                         size_t max_pooled_buffers = 64)
+      : _chunk_size(chunk_size),
+        _file_path(std::move(file_path)),
+        _mutex(std::make_unique<std::mutex>()),
+        _buffer_pool(max_pooled_buffers) {
+    // the file is validated before the backend is chosen, so that both backends fail the same way
+    _fd = ::open(_file_path.c_str(), O_RDONLY);
+    if (_fd == -1) {
+      throw std::runtime_error("IoUringReader: cannot open '" + _file_path + "': " + std::strerror(errno));
+    }
+    struct stat st {};
+    if (::fstat(_fd, &st) == -1) {
+      ::close(_fd);
+      throw std::runtime_error("IoUringReader: cannot stat '" + _file_path + "': " + std::strerror(errno));
+    }
+    _size = static_cast<uint64_t>(st.st_size);
+    try {
+      _ring = std::make_unique<utils::IoUring>(queue_depth);
+    } catch (const std::system_error&) {
+      ::close(std::exchange(_fd, -1));
+      _fallback = std::make_unique<FileReader<T>>(_file_path, _chunk_size, false, max_pooled_buffers);
+      return;
+    }
+    _requests.resize(std::min<size_t>(queue_depth, _ring->entries()));
+    for (size_t i = 0; i < _requests.size(); ++i) {
+      _free_requests.push_back(i);
+    }
+  }
+
+  ~IoUringReader() {
+    if (_ring != nullptr && _in_flight > 0) {
+      // the kernel may still write into our buffers: wait for all pending reads
+      _ring->submit(0);
+      while (_in_flight > 0) {
+        if (!_ring->pop_completion()) {
+          _ring->submit(1);
+          continue;
+        }
+        _in_flight--;
+      }
+    }
+    _ring.reset();
+    if (_fd != -1) {
+      ::close(_fd);
+    }
+  }
+
+  /// not copyable
+  IoUringReader(const IoUringReader&) = delete;
+  IoUringReader& operator=(const IoUringReader&) = delete;
+
+  /// movable (only before reading started)
+  IoUringReader(IoUringReader&& other) noexcept
+      : _chunk_size(other._chunk_size),
+        _file_path(std::move(other._file_path)),
+        _fd(std::exchange(other._fd, -1)),
+        _size(other._size),
+        _next_offset(other._next_offset),
+        _in_flight(std::exchange(other._in_flight, 0)),
+        _ring(std::move(other._ring)),
+        _requests(std::move(other._requests)),
+        _free_requests(std::move(other._free_requests)),
+        _completed_requests(std::move(other._completed_requests)),
+        _fallback(std::move(other._fallback)),
+        _mutex(std::move(other._mutex)),
+        _buffer_pool(std::move(other._buffer_pool)) {}
+  IoUringReader& operator=(IoUringReader&&) = delete;
+
+  std::optional<T> operator()() override {
+    std::unique_lock lock(*_mutex);
+    if (_fallback != nullptr) {
+      return (*_fallback)();
+    }
+    while (true) {
+      queue_reads();
+      if (!_completed_requests.empty()) {
+        size_t index = _completed_requests.front();
+        _completed_requests.pop_front();
+        Request& request = _requests[index];
+        T data = std::move(request.data);
+        data.resize(request.done);
+        if constexpr (MutableOffsetDataC<T>) {
+          data.set_offset(request.offset);
+        }
+        // requests are queued at multiples of the chunk size
+        _set_sequence_number(data, request.offset / _chunk_size);
+        _free_requests.push_back(index);
+        // keep the ring filled while the chunk is searched
+        queue_reads();
+        _ring->submit(0);
+        return std::make_optional(std::move(data));
+      }
+      if (_in_flight == 0) {
+        return {};
+      }
+      _ring->submit(1);
+      reap_completions();
+    }
+  }
+
+  /// handed on to xs::FileReader if io_uring is not available
+  void recycle(T&& data) {
+    if (_fallback != nullptr) {
+      _fallback->recycle(std::move(data));
+      return;
+    }
+    _buffer_pool.release(std::move(data));
+  }
+
+  /// true if io_uring is not available and xs::FileReader is used instead
+  [[nodiscard]] bool is_fallback() const { return _fallback != nullptr; }
+
+ private:
+  /// queue reads of the next chunks for all free requests
+  void queue_reads() {
+    while (!_free_requests.empty() && _next_offset < _size) {
+      size_t index = _free_requests.back();
+      Request& request = _requests[index];
+      request.data = _buffer_pool.acquire();
+      request.offset = _next_offset;
+      request.size = std::min<uint64_t>(_chunk_size, _size - _next_offset);
+      request.done = 0;
+      request.data.resize(request.size);
+      if (!_ring->prepare_read(_fd, request.data.data(), request.size, request.offset, index)) {
+        _buffer_pool.release(std::move(request.data));
+        return;
+      }
+      _free_requests.pop_back();
+      _next_offset += request.size;
+      _in_flight++;
+    }
+  }
+
+  void reap_completions() {
+    while (auto completion = _ring->pop_completion()) {
+      Request& request = _requests[completion->user_data];
+      if (completion->result == -EINTR || completion->result == -EAGAIN) {
+        requeue(completion->user_data);
+        continue;
+      }
+      if (completion->result < 0) {
+        fail_request(completion->user_data,
+                     "IoUringReader: cannot read '" + _file_path + "': " + std::strerror(-completion->result));
+      }
+      request.done += static_cast<size_t>(completion->result);
+      if (completion->result > 0 && request.done < request.size) {
+        // partial read: read the rest of the chunk
+        requeue(completion->user_data);
+        continue;
+      }
+      _in_flight--;
+      _completed_requests.push_back(completion->user_data);
+    }
+  }
+
+  void requeue(uint64_t index) {
+    Request& request = _requests[index];
+    for (int attempt = 0; attempt < 2; ++attempt) {
+      if (_ring->prepare_read(_fd, request.data.data() + request.done, request.size - request.done,
+                              request.offset + request.done, index)) {
+        return;
+      }
+      // submission queue full: hand the queued reads to the kernel, which frees their entries
+      try {
+        _ring->submit(0);
+      } catch (const std::system_error& e) {
+        fail_request(index, "IoUringReader: cannot read '" + _file_path + "': " + e.what());
+      }
+    }
+    fail_request(index, "IoUringReader: cannot queue read of '" + _file_path + "': submission queue full");
+  }
+
+  /// the read of request index failed: it is not in flight anymore, hand its buffer back and throw
+  [[noreturn]] void fail_request(uint64_t index, const std::string& message) {
+    _buffer_pool.release(std::move(_requests[index].data));
+    _free_requests.push_back(index);
+    _in_flight--;
+    throw std::runtime_error(message);
+  }
+
+  size_t _chunk_size;
+  std::string _file_path;
+  int _fd = -1;
+  uint64_t _size = 0;
+  uint64_t _next_offset = 0;
+  size_t _in_flight = 0;
+
+  std::unique_ptr<utils::IoUring> _ring;
+  std::vector<Request> _requests;
+  std::vector<size_t> _free_requests;
+  std::deque<size_t> _completed_requests;
+
+  std::unique_ptr<FileReader<T>> _fallback;
+  std::unique_ptr<std::mutex> _mutex;
+  utils::BufferPool<T> _buffer_pool;
+};
+
+/**
+ * Reader for large cold scans that does not pollute the page cache, so that co-located workloads keep their cache.
+ *  Like xs::PReadFileReader, chunks are claimed using an atomic chunk index and read concurrently using pread().
+ *
+ * direct_io = true: the file is opened with O_DIRECT. Reads bypass the page cache and go to the device directly.
+ *  Chunk offsets and sizes are multiples of alignment, the last (unaligned) block of the file is read by requesting
+ *  a whole block and accepting the short read. T must provide buffers aligned to alignment (c.f. AlignedDataChunk).
+ *  If the file system does not support O_DIRECT (open() fails, or reads fail with EINVAL as on some tmpfs/overlayfs
+ *  mounts), the reader falls back to direct_io = false.
+ * direct_io = false: buffered reads, every chunk is dropped from the page cache (POSIX_FADV_DONTNEED) right after
+ *  it was copied into the chunk buffer, i.e. behind the scan cursor.
+ */
+template <ResizableDataC T = xs::AlignedDataChunk>
+class DirectFileReader : Reader_I<T> {
+ public:
+  static constexpr bool concurrent_access = true;
+
+  explicit DirectFileReader(std::string file_path, size_t chunk_size = 524288, bool direct_io = true,
+                            size_t alignment = 4096, size_t max_pooled_buffers = 64)
+      : _chunk_size(std::max(alignment, chunk_size - chunk_size % alignment)),
+        _alignment(alignment),
+        _file_path(std::move(file_path)),
+        _buffer_pool(max_pooled_buffers) {
+    if constexpr (requires { T::allocator_type::alignment; }) {
+      if (alignment == 0 || alignment > T::allocator_type::alignment || T::allocator_type::alignment % alignment != 0) {
+        throw std::runtime_error("DirectFileReader: alignment " + std::to_string(alignment) +
+                                 " is not supported by chunk buffers aligned to " +
+                                 std::to_string(T::allocator_type::alignment) + " bytes");
+      }
+    }
+    if (direct_io) {
+      _fd = ::open(_file_path.c_str(), O_RDONLY | O_DIRECT);
+      _direct_io = _fd != -1;
+    }
+    if (_fd == -1) {
+      _fd = ::open(_file_path.c_str(), O_RDONLY);
+    }
+    if (_fd == -1) {
+      throw std::runtime_error("DirectFileReader: cannot open '" + _file_path + "': " + std::strerror(errno));
+    }
+    struct stat st {};
+    if (::fstat(_fd, &st) == -1) {
+      ::close(_fd);
+      throw std::runtime_error("DirectFileReader: cannot stat '" + _file_path + "': " + std::strerror(errno));
+    }
+    _size = static_cast<uint64_t>(st.st_size);
+    if (!_direct_io) {
+      ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+  }
+
+  ~DirectFileReader() {
+    if (_fd != -1) {
+      ::close(_fd);
+    }
+    if (_buffered_fd != -1) {
+      ::close(_buffered_fd);
+    }
+  }
+
+  /// not copyable
+  DirectFileReader(const DirectFileReader&) = delete;
+  DirectFileReader& operator=(const DirectFileReader&) = delete;
+
+  /// movable: the file descriptor is handed over to the new reader
+  DirectFileReader(DirectFileReader&& other) noexcept
+      : _chunk_size(other._chunk_size),
+        _alignment(other._alignment),
+        _direct_io(other._direct_io.load()),
+        _file_path(std::move(other._file_path)),
+        _fd(std::exchange(other._fd, -1)),
+        _buffered_fd(other._buffered_fd.exchange(-1)),
+        _size(other._size),
+        _next_chunk_index(other._next_chunk_index.load()),
+        _buffer_pool(std::move(other._buffer_pool)) {}
+  DirectFileReader& operator=(DirectFileReader&&) = delete;
+
+  std::optional<T> operator()() override {
+    uint64_t index = _next_chunk_index.fetch_add(1);
+    uint64_t begin = index * _chunk_size;
+    if (begin >= _size) {
+      return {};
+    }
+    size_t size = std::min<uint64_t>(_chunk_size, _size - begin);
+    T data = _buffer_pool.acquire();
+    bool direct_io = _direct_io.load();
+    if (direct_io) {
+      // the unaligned tail of the file is read as a whole block, the read stops at the end of the file
+      data.resize(size + (_alignment - size % _alignment) % _alignment);
+      if (reinterpret_cast<uintptr_t>(data.data()) % _alignment != 0) {
+        throw std::runtime_error("DirectFileReader: chunk buffers are not aligned to " + std::to_string(_alignment) +
+                                 " bytes");
+      }
+      auto num_bytes = read(_fd, data.data(), data.size(), begin, true);
+      if (num_bytes) {
+        data.resize(num_bytes.value());
+      } else {
+        disable_direct_io();
+        direct_io = false;
+      }
+    }
+    if (!direct_io) {
+      data.resize(size);
+      data.resize(read(buffered_fd(), data.data(), data.size(), begin, false).value());
+      ::posix_fadvise(buffered_fd(), static_cast<off_t>(begin), static_cast<off_t>(size), POSIX_FADV_DONTNEED);
+    }
+    if constexpr (MutableOffsetDataC<T>) {
+      data.set_offset(begin);
+    }
+    _set_sequence_number(data, index);
+    return std::make_optional(std::move(data));
+  }
+
+  void recycle(T&& data) { _buffer_pool.release(std::move(data)); }
+
+  /// true if the file is read using O_DIRECT
+  [[nodiscard]] bool is_direct() const { return _direct_io.load(); }
+
+ private:
+  /// read size bytes at offset into dest, std::nullopt if an O_DIRECT read is rejected (EINVAL)
+  std::optional<size_t> read(int fd, char* dest, size_t size, uint64_t offset, bool direct_io) const {
+    size_t total = 0;
+    while (total < size) {
+      ssize_t num_bytes = ::pread(fd, dest + total, size - total, static_cast<off_t>(offset + total));
+      if (num_bytes == -1) {
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno == EINVAL && direct_io) {
+          return {};
+        }
+        throw std::runtime_error("DirectFileReader: cannot read '" + _file_path + "': " + std::strerror(errno));
+      }
+      total += static_cast<size_t>(num_bytes);
+      // short reads happen at the end of the file. O_DIRECT reads cannot be continued at unaligned offsets anyway
+      if (num_bytes == 0 || (direct_io && total % _alignment != 0)) {
+        break;
+      }
+    }
+    return total;
+  }
+
+  /// the file system accepted O_DIRECT on open() but rejects the reads: continue with buffered reads
+  void disable_direct_io() {
+    if (_buffered_fd.load() == -1) {
+      int fd = ::open(_file_path.c_str(), O_RDONLY);
+      if (fd == -1) {
+        throw std::runtime_error("DirectFileReader: cannot open '" + _file_path + "': " + std::strerror(errno));
+      }
+      ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+      int expected = -1;
+      if (!_buffered_fd.compare_exchange_strong(expected, fd)) {
+        // opened by another thread concurrently
+        ::close(fd);
+      }
+    }
+    _direct_io.store(false);
+  }
+
+  /// descriptor for buffered reads
+  [[nodiscard]] int buffered_fd() const {
+    int fd = _buffered_fd.load();
+    return fd != -1 ? fd : _fd;
+  }
+
+  size_t _chunk_size;
+  size_t _alignment;
+  std::atomic<bool> _direct_io = false;
+  std::string _file_path;
+  int _fd = -1;
+  /// opened without O_DIRECT once O_DIRECT reads were rejected, c.f. disable_direct_io()
+  std::atomic<int> _buffered_fd = -1;
+  uint64_t _size = 0;
+  std::atomic<uint64_t> _next_chunk_index{0};
+  utils::BufferPool<T> _buffer_pool;
+};
+
+/**
+ * Reads many files (e.g. all files of directory trees) with file level and chunk level parallelism: the files are
+ *  collected by a parallel directory walk (c.f. utils::list_files()) and partitioned into tasks of about chunk_size
+ *  bytes each:
+ *   - small files are batched: one task (and one chunk) holds as many files as fit into chunk_size, so that searching
+ *     many tiny files does not cost a search call and a queue round trip per file.
+ *   - large files are split into several tasks that are aligned to line boundaries when read (c.f. PReadFileReader).
+ *  Tasks are claimed using an atomic task index, so the reader can be called by all search threads concurrently.
+ *  The files of the task prefetch_distance tasks ahead are prefetched into the page cache (POSIX_FADV_WILLNEED)
+ *  whenever a task is claimed, overlapping the open and read latency of upcoming files with searching. Files smaller
+ *  than min_prefetch_size are not prefetched: announcing them costs as many syscalls as reading them.
+ *
+ * Each chunk records which of its bytes belong to which file (c.f. xs::MultiFileChunk::segments()). Files are
+ *  identified by their index in files(); search them using xs::MultiFileSearcher. Reading a chunk throws
+ *  std::runtime_error if one of its files cannot be opened (e.g. it vanished after the walk).
+ */
+template <ResizableDataC T = xs::MultiFileChunk>
+class MultiFileReader : Reader_I<T> {
+  struct Range {
+    uint64_t file_id = 0;
+    uint64_t begin = 0;
+    uint64_t end = 0;
+    /// true if the range is a part of a split file: its bounds are moved to line boundaries when read
+    bool partial = false;
+  };
+
+ public:
+  static constexpr bool concurrent_access = true;
+
+  explicit MultiFileReader(const std::vector<std::string>& paths, size_t chunk_size = 524288,
+                           size_t prefetch_distance = 4, size_t num_walker_threads = 4, size_t max_pooled_buffers = 64)
+      : _chunk_size(std::max<size_t>(1, chunk_size)),
+        _prefetch_distance(prefetch_distance),
+        _files(std::make_shared<const std::vector<utils::FileInfo>>(utils::list_files(paths, num_walker_threads))),
+        _buffer_pool(max_pooled_buffers) {
+    std::vector<Range> batch;
+    uint64_t batch_size = 0;
+    for (uint64_t file_id = 0; file_id < _files->size(); ++file_id) {
+      uint64_t size = (*_files)[file_id].size;
+      if (size == 0) {
+        continue;
+      }
+      if (size > _chunk_size) {
+        for (uint64_t begin = 0; begin < size; begin += _chunk_size) {
+          _tasks.push_back({{file_id, begin, std::min<uint64_t>(begin + _chunk_size, size), true}});
+        }
+        continue;
+      }
+      if (batch_size + size > _chunk_size) {
+        _tasks.push_back(std::move(batch));
+        batch.clear();
+        batch_size = 0;
+      }
+      batch.push_back({file_id, 0, size, false});
+      batch_size += size;
+    }
+    if (!batch.empty()) {
+      _tasks.push_back(std::move(batch));
+    }
+    for (size_t index = 0; index < std::min(_prefetch_distance, _tasks.size()); ++index) {
+      prefetch(index);
+    }
+  }
+
+  /// not copyable
+  MultiFileReader(const MultiFileReader&) = delete;
+  MultiFileReader& operator=(const MultiFileReader&) = delete;
+
+  MultiFileReader(MultiFileReader&& other) noexcept
+      : _chunk_size(other._chunk_size),
+        _prefetch_distance(other._prefetch_distance),
+        _files(std::move(other._files)),
+        _tasks(std::move(other._tasks)),
+        _next_task_index(other._next_task_index.load()),
+        _buffer_pool(std::move(other._buffer_pool)) {}
+  MultiFileReader& operator=(MultiFileReader&&) = delete;
+
+  std::optional<T> operator()() override {
+    size_t index = _next_task_index.fetch_add(1);
+    if (index >= _tasks.size()) {
+      return {};
+    }
+    if (_prefetch_distance > 0) {
+      prefetch(index + _prefetch_distance);
+    }
+    T data = _buffer_pool.acquire();
+    data.segments().clear();
+    data.resize(0);
+    for (const auto& range : _tasks[index]) {
+      read(range, data);
+    }
+    // returned even without segments (a range within a line started by a previous task), so that the sequence
+    //  numbers stay gapless
+    _set_sequence_number(data, index);
+    return std::make_optional(std::move(data));
+  }
+
+  void recycle(T&& data) { _buffer_pool.release(std::move(data)); }
+
+  /**
+   * The searched files, indexed by the file ids of the chunk segments. Shared, so that it stays available after the
+   *  reader was moved into an xs::Searcher.
+   */
+  [[nodiscard]] std::shared_ptr<const std::vector<utils::FileInfo>> files() const { return _files; }
+
+  /// number of tasks (chunks) the files were partitioned into
+  [[nodiscard]] size_t num_tasks() const { return _tasks.size(); }
+
+ private:
+  /// append the bytes of range to data and record them as a segment
+  void read(const Range& range, T& data) const {
+    const auto& file = (*_files)[range.file_id];
+    int fd = ::open(file.path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      throw std::runtime_error("MultiFileReader: cannot open '" + file.path + "': " + std::strerror(errno));
+    }
+    try {
+      uint64_t begin = range.begin;
+      uint64_t end = range.end;
+      if (range.partial) {
+        std::tie(begin, end) = _line_aligned_range(fd, begin, _chunk_size, file.size, file.path);
+      }
+      if (begin < end) {
+        size_t position = data.size();
+        data.resize(position + (end - begin));
+        size_t num_bytes = _pread_all(fd, data.data() + position, end - begin, begin, file.path);
+        data.resize(position + num_bytes);
+        if (num_bytes > 0) {
+          data.segments().push_back({range.file_id, position, num_bytes, begin});
+        }
+      }
+    } catch (...) {
+      ::close(fd);
+      throw;
+    }
+    ::close(fd);
+  }
+
+  /// announce the ranges of the task at index to the kernel
+  void prefetch(size_t index) const {
+    if (index >= _tasks.size()) {
+      return;
+    }
+    for (const auto& range : _tasks[index]) {
+      if (!range.partial && range.end - range.begin < min_prefetch_size) {
+        continue;
+      }
+      int fd = ::open((*_files)[range.file_id].path.c_str(), O_RDONLY);
+      if (fd == -1) {
+        continue;
+      }
+      ::posix_fadvise(fd, static_cast<off_t>(range.begin), static_cast<off_t>(range.end - range.begin),
+                      POSIX_FADV_WILLNEED);
+      ::close(fd);
+    }
+  }
+
+  /// smaller (not split) files are read without being prefetched, c.f. prefetch()
+  static constexpr uint64_t min_prefetch_size = 1 << 16;
+
+  size_t _chunk_size;
+  size_t _prefetch_distance;
+  std::shared_ptr<const std::vector<utils::FileInfo>> _files;
+  std::vector<std::vector<Range>> _tasks;
+  std::atomic<size_t> _next_task_index{0};
+  utils::BufferPool<T> _buffer_pool;
+};
+
+/**
+ * Store the global offset (and line mapping data, if T supports it, c.f. xs::LineMappedDataChunk) of a chunk read
+ *  using its meta data in the chunk. The sequence number of the chunk is its index within the meta file.
+ */
+template <typename T>
+void _apply_chunk_meta_data(T& data, ChunkMetaData& cmd, uint64_t chunk_index) {
+  _set_sequence_number(data, chunk_index);
+  if constexpr (MutableOffsetDataC<T>) {
+    data.set_offset(cmd.original_offset);
+  }
+  if constexpr (requires { data.set_line_mapping_data(std::move(cmd.line_mapping_data)); }) {
+    data.set_line_mapping_data(std::move(cmd.line_mapping_data));
+  }
+}
+
+/// ZSTD decompression context of the calling thread, created on first use and freed when the thread exits
+inline ZSTD_DCtx* _zstd_thread_context() {
+  struct Deleter {
+    void operator()(ZSTD_DCtx* dctx) const { ZSTD_freeDCtx(dctx); }
+  };
+  thread_local std::unique_ptr<ZSTD_DCtx, Deleter> dctx(ZSTD_createDCtx());
+  if (dctx == nullptr) {
+    throw std::runtime_error("cannot create ZSTD decompression context");
+  }
+  return dctx.get();
+}
+
+/**
+ * Load the ZSTD dictionary stored in meta_file (c.f. PreprocessOptions::dictionary_size) as prepared ZSTD_DDict that
+ *  is shared by all threads. nullptr if the meta file has no dictionary.
+ */
+inline std::shared_ptr<ZSTD_DDict> _load_zstd_ddict(const MetaFile& meta_file, const std::string& reader_name,
+                                                    const std::string& file_path) {
+  auto dictionary = meta_file.dictionary();
+  if (dictionary.empty()) {
+    return nullptr;
+  }
+  std::shared_ptr<ZSTD_DDict> ddict(ZSTD_createDDict(dictionary.data(), dictionary.size()),
+                                    [](ZSTD_DDict* d) { ZSTD_freeDDict(d); });
+  if (ddict == nullptr) {
+    throw std::runtime_error(reader_name + ": cannot load the dictionary of '" + file_path + "'");
+  }
+  return ddict;
+}
+
+/// decompress the LZ4 compressed chunk described by cmd into data (resized to its original size)
+template <ResizableDataC T>
+void _decompress_lz4_chunk(const strtype& compressed, T& data, const ChunkMetaData& cmd, const std::string& reader_name,
+                           const std::string& file_path) {
+  if (cmd.actual_size > LZ4_MAX_INPUT_SIZE || cmd.original_size > LZ4_MAX_INPUT_SIZE) {
+    throw std::runtime_error(reader_name + ": chunk at offset " + std::to_string(cmd.actual_offset) + " of '" +
+                             file_path + "' exceeds the LZ4 block size limit");
+  }
+  data.resize(cmd.original_size);
+  int num_bytes = LZ4_decompress_safe(compressed.data(), data.data(), static_cast<int>(cmd.actual_size),
+                                      static_cast<int>(cmd.original_size));
+  if (num_bytes < 0 || static_cast<uint64_t>(num_bytes) != cmd.original_size) {
+    throw std::runtime_error(reader_name + ": cannot decompress LZ4 chunk at offset " +
+                             std::to_string(cmd.actual_offset) + " of '" + file_path + "'");
+  }
+}
+
+/**
+ * Decompress the ZSTD compressed chunk described by cmd into data (resized to its original size) using the
+ *  decompression context of the calling thread and ddict, if not nullptr (c.f. _load_zstd_ddict()).
+ */
+template <ResizableDataC T>
+void _decompress_zstd_chunk(const strtype& compressed, T& data, const ChunkMetaData& cmd, const ZSTD_DDict* ddict,
+                            const std::string& reader_name, const std::string& file_path) {
+  data.resize(cmd.original_size);
+  size_t num_bytes;
+  if (ddict == nullptr) {
+    num_bytes = ZSTD_decompressDCtx(_zstd_thread_context(), data.data(), cmd.original_size, compressed.data(),
+                                    cmd.actual_size);
+  } else {
+    num_bytes = ZSTD_decompress_usingDDict(_zstd_thread_context(), data.data(), cmd.original_size, compressed.data(),
+                                           cmd.actual_size, ddict);
+  }
+  if (ZSTD_isError(num_bytes)) {
+    throw std::runtime_error(reader_name + ": cannot decompress ZSTD chunk at offset " +
+                             std::to_string(cmd.actual_offset) + " of '" + file_path +
+                             "': " + ZSTD_getErrorName(num_bytes));
+  }
+  if (num_bytes != cmd.original_size) {
+    throw std::runtime_error(reader_name + ": chunk at offset " + std::to_string(cmd.actual_offset) + " of '" +
+                             file_path + "' does not match its meta data");
+  }
+}
+
+/**
+ * Reads a file that was split into chunks by preprocessing (c.f. xs::MetaFile): the chunk boundaries are taken from
+ *  the meta file, so chunks are claimed and read (pread()) by all search threads concurrently without scanning for
+ *  line boundaries. Global byte offsets (and, if T provides set_line_mapping_data(), the line mapping data, c.f.
+ *  xs::LineMappedDataChunk) are set from the chunk meta data.
+ *
+ * Only uncompressed files (CompressionType::NONE) can be read.
+ */
+template <ResizableDataC T = xs::LineMappedDataChunk>
+class ChunkReader : Reader_I<T> {
+ public:
+  static constexpr bool concurrent_access = true;
+
+  ChunkReader(std::string file_path, const std::string& meta_file_path, size_t max_pooled_buffers = 64)
+      : _file_path(std::move(file_path)),
+        _meta_file(std::make_unique<MetaFile>(meta_file_path, std::ios::in)),
+        _buffer_pool(max_pooled_buffers) {
+    if (_meta_file->get_compression_type() != CompressionType::NONE) {
+      throw std::runtime_error("ChunkReader: '" + _file_path + "' is compressed (" +
+                               to_string(_meta_file->get_compression_type()) + ")");
+    }
+    _fd = ::open(_file_path.c_str(), O_RDONLY);
+    if (_fd == -1) {
+      throw std::runtime_error("ChunkReader: cannot open '" + _file_path + "': " + std::strerror(errno));
+    }
+    ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  }
+
+  ~ChunkReader() {
+    if (_fd != -1) {
+      ::close(_fd);
+    }
+  }
+
+  /// not copyable
+  ChunkReader(const ChunkReader&) = delete;
+  ChunkReader& operator=(const ChunkReader&) = delete;
+
+  /// movable: the file descriptor and the meta file are handed over to the new reader
+  ChunkReader(ChunkReader&& other) noexcept
+      : _file_path(std::move(other._file_path)),
+        _fd(std::exchange(other._fd, -1)),
+        _meta_file(std::move(other._meta_file)),
+        _buffer_pool(std::move(other._buffer_pool)) {}
+  ChunkReader& operator=(ChunkReader&&) = delete;
+
+  std::optional<T> operator()() override {
+    auto index = _meta_file->next_chunk_index();
+    if (!index) {
+      return {};
+    }
+    auto cmd = _meta_file->chunk_meta_data(index.value());
+    T data = _buffer_pool.acquire();
+    data.resize(cmd->actual_size);
+    if (_pread_all(_fd, data.data(), cmd->actual_size, cmd->actual_offset, _file_path) != cmd->actual_size) {
+      throw std::runtime_error("ChunkReader: '" + _file_path + "' is shorter than described by its meta file");
+    }
+    _apply_chunk_meta_data(data, cmd.value(), index.value());
+    return std::make_optional(std::move(data));
+  }
+
+  void recycle(T&& data) { _buffer_pool.release(std::move(data)); }
+
+  /// number of chunks of the file
+  [[nodiscard]] size_t num_chunks() const { return _meta_file->num_chunks(); }
+
+ private:
+  std::string _file_path;
+  int _fd = -1;
+  std::unique_ptr<MetaFile> _meta_file;
+  utils::BufferPool<T> _buffer_pool;
+};
+
+/**
+ * Reads a file that was split into chunks and compressed chunk by chunk using LZ4 (or LZ4 HC, both decompress alike)
+ *  during preprocessing (c.f. xs::MetaFile). The compressed extents are taken from the meta file.
+ *
+ * Reading and decompression are not serialized: every search thread claims the next chunk, preads its compressed
+ *  bytes and decompresses them into a pooled buffer itself, right before it searches the chunk. Decompression thereby
+ *  scales with the number of search threads. Compressed and decompressed buffers are reused.
+ */
+template <ResizableDataC T = xs::LineMappedDataChunk>
+class LZ4ChunkReader : Reader_I<T> {
+ public:
+  static constexpr bool concurrent_access = true;
+
+  LZ4ChunkReader(std::string file_path, const std::string& meta_file_path, size_t max_pooled_buffers = 64)
+      : _file_path(std::move(file_path)),
+        _meta_file(std::make_unique<MetaFile>(meta_file_path, std::ios::in)),
+        _buffer_pool(max_pooled_buffers),
+        _compressed_buffer_pool(max_pooled_buffers) {
+    if (_meta_file->get_compression_type() != CompressionType::LZ4) {
+      throw std::runtime_error("LZ4ChunkReader: '" + _file_path + "' is not LZ4 compressed (" +
+                               to_string(_meta_file->get_compression_type()) + ")");
+    }
+    _fd = ::open(_file_path.c_str(), O_RDONLY);
+    if (_fd == -1) {
+      throw std::runtime_error("LZ4ChunkReader: cannot open '" + _file_path + "': " + std::strerror(errno));
+    }
+    ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  }
+
+  ~LZ4ChunkReader() {
+    if (_fd != -1) {
+      ::close(_fd);
+    }
+  }
+
+  /// not copyable
+  LZ4ChunkReader(const LZ4ChunkReader&) = delete;
+  LZ4ChunkReader& operator=(const LZ4ChunkReader&) = delete;
+
+  /// movable: the file descriptor and the meta file are handed over to the new reader
+  LZ4ChunkReader(LZ4ChunkReader&& other) noexcept
+      : _file_path(std::move(other._file_path)),
+        _fd(std::exchange(other._fd, -1)),
+        _meta_file(std::move(other._meta_file)),
+        _buffer_pool(std::move(other._buffer_pool)),
+        _compressed_buffer_pool(std::move(other._compressed_buffer_pool)) {}
+  LZ4ChunkReader& operator=(LZ4ChunkReader&&) = delete;
+
+  std::optional<T> operator()() override {
+    auto index = _meta_file->next_chunk_index();
+    if (!index) {
+      return {};
+    }
+    auto cmd = _meta_file->chunk_meta_data(index.value());
+    strtype compressed = _compressed_buffer_pool.acquire();
+    compressed.resize(cmd->actual_size);
+    if (_pread_all(_fd, compressed.data(), cmd->actual_size, cmd->actual_offset, _file_path) != cmd->actual_size) {
+      throw std::runtime_error("LZ4ChunkReader: '" + _file_path + "' is shorter than described by its meta file");
+    }
+    T data = _buffer_pool.acquire();
+    _decompress_lz4_chunk(compressed, data, cmd.value(), "LZ4ChunkReader", _file_path);
+    _compressed_buffer_pool.release(std::move(compressed));
+    _apply_chunk_meta_data(data, cmd.value(), index.value());
+    return std::make_optional(std::move(data));
+  }
+
+  void recycle(T&& data) { _buffer_pool.release(std::move(data)); }
+
+  /// number of chunks of the file
+  [[nodiscard]] size_t num_chunks() const { return _meta_file->num_chunks(); }
+
+ private:
+  std::string _file_path;
+  int _fd = -1;
+  std::unique_ptr<MetaFile> _meta_file;
+  utils::BufferPool<T> _buffer_pool;
+  utils::BufferPool<strtype> _compressed_buffer_pool;
+};
+
+/**
+ * Reads a file that was split into chunks and compressed chunk by chunk using ZSTD during preprocessing (c.f.
+ *  xs::MetaFile). Like xs::LZ4ChunkReader, every search thread reads and decompresses the chunks it searches itself.
+ *
+ * Every thread keeps one decompression context (ZSTD_DCtx) for its whole lifetime, so no context is created (nor are
+ *  its internal buffers allocated) per chunk. Compressed and decompressed buffers are pooled.
+ *  If the chunks were compressed using a dictionary (stored in the meta file, c.f. PreprocessOptions::dictionary_size),
+ *  it is loaded once as a prepared ZSTD_DDict that is shared by all threads.
+ */
+template <ResizableDataC T = xs::LineMappedDataChunk>
+class ZstdChunkReader : Reader_I<T> {
+ public:
+  static constexpr bool concurrent_access = true;
+
+  ZstdChunkReader(std::string file_path, const std::string& meta_file_path, size_t max_pooled_buffers = 64)
+      : _file_path(std::move(file_path)),
+        _meta_file(std::make_unique<MetaFile>(meta_file_path, std::ios::in)),
+        _buffer_pool(max_pooled_buffers),
+        _compressed_buffer_pool(max_pooled_buffers) {
+    if (_meta_file->get_compression_type() != CompressionType::ZSTD) {
+      throw std::runtime_error("ZstdChunkReader: '" + _file_path + "' is not ZSTD compressed (" +
+                               to_string(_meta_file->get_compression_type()) + ")");
+    }
+    _ddict = _load_zstd_ddict(*_meta_file, "ZstdChunkReader", _file_path);
+    _fd = ::open(_file_path.c_str(), O_RDONLY);
+    if (_fd == -1) {
+      throw std::runtime_error("ZstdChunkReader: cannot open '" + _file_path + "': " + std::strerror(errno));
+    }
+    ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  }
+
+  ~ZstdChunkReader() {
+    if (_fd != -1) {
+      ::close(_fd);
+    }
+  }
+
+  /// not copyable
+  ZstdChunkReader(const ZstdChunkReader&) = delete;
+  ZstdChunkReader& operator=(const ZstdChunkReader&) = delete;
+
+  /// movable: the file descriptor and the meta file are handed over to the new reader
+  ZstdChunkReader(ZstdChunkReader&& other) noexcept
+      : _file_path(std::move(other._file_path)),
+        _fd(std::exchange(other._fd, -1)),
+        _meta_file(std::move(other._meta_file)),
+        _ddict(std::move(other._ddict)),
+        _buffer_pool(std::move(other._buffer_pool)),
+        _compressed_buffer_pool(std::move(other._compressed_buffer_pool)) {}
+  ZstdChunkReader& operator=(ZstdChunkReader&&) = delete;
+
+  std::optional<T> operator()() override {
+    auto index = _meta_file->next_chunk_index();
+    if (!index) {
+      return {};
+    }
+    auto cmd = _meta_file->chunk_meta_data(index.value());
+    strtype compressed = _compressed_buffer_pool.acquire();
+    compressed.resize(cmd->actual_size);
+    if (_pread_all(_fd, compressed.data(), cmd->actual_size, cmd->actual_offset, _file_path) != cmd->actual_size) {
+      throw std::runtime_error("ZstdChunkReader: '" + _file_path + "' is shorter than described by its meta file");
+    }
+    T data = _buffer_pool.acquire();
+    _decompress_zstd_chunk(compressed, data, cmd.value(), _ddict.get(), "ZstdChunkReader", _file_path);
+    _compressed_buffer_pool.release(std::move(compressed));
+    _apply_chunk_meta_data(data, cmd.value(), index.value());
+    return std::make_optional(std::move(data));
+  }
+
+  void recycle(T&& data) { _buffer_pool.release(std::move(data)); }
+
+  /// number of chunks of the file
+  [[nodiscard]] size_t num_chunks() const { return _meta_file->num_chunks(); }
+
+  /// true if the chunks are decompressed using a dictionary
+  [[nodiscard]] bool uses_dictionary() const { return _ddict != nullptr; }
+
+ private:
+  std::string _file_path;
+  int _fd = -1;
+  std::unique_ptr<MetaFile> _meta_file;
+  std::shared_ptr<ZSTD_DDict> _ddict;
+  utils::BufferPool<T> _buffer_pool;
+  utils::BufferPool<strtype> _compressed_buffer_pool;
+};
+
+/**
+ * Reads a file preprocessed using PreprocessOptions::Algorithm::ADAPTIVE (CompressionType::MIXED): the compression
+ *  type of every chunk is taken from its meta data. Raw chunks are read (pread()) directly into the chunk buffer and
+ *  are not touched by any decompressor, LZ4 and ZSTD chunks are decompressed like by xs::LZ4ChunkReader and
+ *  xs::ZstdChunkReader (using the dictionary stored in the meta file, if any) by the thread that searches them.
+ */
+template <ResizableDataC T = xs::LineMappedDataChunk>
+class MixedChunkReader : Reader_I<T> {
+ public:
+  static constexpr bool concurrent_access = true;
+
+  MixedChunkReader(std::string file_path, const std::string& meta_file_path, size_t max_pooled_buffers = 64)
+      : _file_path(std::move(file_path)),
+        _meta_file(std::make_unique<MetaFile>(meta_file_path, std::ios::in)),
+        _buffer_pool(max_pooled_buffers),
+        _compressed_buffer_pool(max_pooled_buffers) {
+    if (_meta_file->get_compression_type() != CompressionType::MIXED) {
+      throw std::runtime_error("MixedChunkReader: '" + _file_path + "' is not adaptively compressed (" +
+                               to_string(_meta_file->get_compression_type()) + ")");
+    }
+    _ddict = _load_zstd_ddict(*_meta_file, "MixedChunkReader", _file_path);
+    _fd = ::open(_file_path.c_str(), O_RDONLY);
+    if (_fd == -1) {
+      throw std::runtime_error("MixedChunkReader: cannot open '" + _file_path + "': " + std::strerror(errno));
+    }
+    ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  }
+
+  ~MixedChunkReader() {
+    if (_fd != -1) {
+      ::close(_fd);
+    }
+  }
+
+  /// not copyable
+  MixedChunkReader(const MixedChunkReader&) = delete;
+  MixedChunkReader& operator=(const MixedChunkReader&) = delete;
+
+  /// movable: the file descriptor and the meta file are handed over to the new reader
+  MixedChunkReader(MixedChunkReader&& other) noexcept
+      : _file_path(std::move(other._file_path)),
+        _fd(std::exchange(other._fd, -1)),
+        _meta_file(std::move(other._meta_file)),
+        _ddict(std::move(other._ddict)),
+        _buffer_pool(std::move(other._buffer_pool)),
+        _compressed_buffer_pool(std::move(other._compressed_buffer_pool)) {}
+  MixedChunkReader& operator=(MixedChunkReader&&) = delete;
+
+  std::optional<T> operator()() override {
+    auto index = _meta_file->next_chunk_index();
+    if (!index) {
+      return {};
+    }
+    auto cmd = _meta_file->chunk_meta_data(index.value());
+    T data = _buffer_pool.acquire();
+    data.resize(cmd->original_size);
+    if (cmd->compression_type == CompressionType::NONE) {
+      if (cmd->actual_size != cmd->original_size ||
+          _pread_all(_fd, data.data(), cmd->actual_size, cmd->actual_offset, _file_path) != cmd->actual_size) {
+        throw std::runtime_error("MixedChunkReader: '" + _file_path + "' does not match its meta file");
+      }
+      _apply_chunk_meta_data(data, cmd.value(), index.value());
+      return std::make_optional(std::move(data));
+    }
+    strtype compressed = _compressed_buffer_pool.acquire();
+    compressed.resize(cmd->actual_size);
+    if (_pread_all(_fd, compressed.data(), cmd->actual_size, cmd->actual_offset, _file_path) != cmd->actual_size) {
+      throw std::runtime_error("MixedChunkReader: '" + _file_path + "' is shorter than described by its meta file");
+    }
+    if (cmd->compression_type == CompressionType::LZ4) {
+      _decompress_lz4_chunk(compressed, data, cmd.value(), "MixedChunkReader", _file_path);
+    } else if (cmd->compression_type == CompressionType::ZSTD) {
+      _decompress_zstd_chunk(compressed, data, cmd.value(), _ddict.get(), "MixedChunkReader", _file_path);
+    } else {
+      throw std::runtime_error("MixedChunkReader: chunk at offset " + std::to_string(cmd->actual_offset) + " of '" +
+                               _file_path + "' has unsupported compression type " +
+                               to_string(cmd->compression_type));
+    }
+    _compressed_buffer_pool.release(std::move(compressed));
+    _apply_chunk_meta_data(data, cmd.value(), index.value());
+    return std::make_optional(std::move(data));
+  }
+
+  void recycle(T&& data) { _buffer_pool.release(std::move(data)); }
+
+  /// number of chunks of the file
+  [[nodiscard]] size_t num_chunks() const { return _meta_file->num_chunks(); }
+
+ private:
+  std::string _file_path;
+  int _fd = -1;
+  std::unique_ptr<MetaFile> _meta_file;
+  std::shared_ptr<ZSTD_DDict> _ddict;
+  utils::BufferPool<T> _buffer_pool;
+  utils::BufferPool<strtype> _compressed_buffer_pool;
+};
+
+/**
+ * Reads gzip files (c.f. zran.c of zlib) using an index of inflate checkpoints (c.f. xs::GzipIndex) that is stored
+ *  next to the file (index_path, default: <file_path>.xsgzi).
+ *
+ * Without (valid) index, the file is inflated sequentially (serialized between the calling threads) and an index with
+ *  a checkpoint every chunk_size uncompressed bytes is built as a side effect. It is saved once the whole file was
+ *  read, unless save_index is false.
+ * With index, every checkpoint starts a chunk: the search threads claim checkpoints and inflate the regions between
+ *  them concurrently. Chunks are moved to line boundaries: a chunk starts with the first line starting at or after
+ *  its checkpoint (whether the preceding byte is a new line char is known from the checkpoint window) and ends with
+ *  the first line starting at or after the next checkpoint, i.e. it inflates a bit beyond its region.
+ *
+ * Chunks are newline-aligned in both modes and carry their global (uncompressed) offsets if T provides set_offset().
+ */
+template <ResizableDataC T = xs::DataChunk>
+class GzipReader : Reader_I<T> {
+ public:
+  static constexpr bool concurrent_access = true;
+
+  explicit GzipReader(std::string file_path, size_t chunk_size = 1 << 23, std::string index_path = "",
+                      bool save_index = true, size_t max_pooled_buffers = 64)
+      : _file_path(std::move(file_path)),
+        _index_path(index_path.empty() ? _file_path + ".xsgzi" : std::move(index_path)),
+        _chunk_size(std::max<size_t>(1, chunk_size)),
+        _save_index(save_index),
+        _mutex(std::make_unique<std::mutex>()),
+        _buffer_pool(max_pooled_buffers) {
+    _fd = ::open(_file_path.c_str(), O_RDONLY);
+    if (_fd == -1) {
+      throw std::runtime_error("GzipReader: cannot open '" + _file_path + "': " + std::strerror(errno));
+    }
+    struct stat st {};
+    if (::fstat(_fd, &st) == -1) {
+      ::close(_fd);
+      throw std::runtime_error("GzipReader: cannot stat '" + _file_path + "': " + std::strerror(errno));
+    }
+    _compressed_size = static_cast<uint64_t>(st.st_size);
+    auto index = GzipIndex::load(_index_path, _compressed_size);
+    if (index && !index->points().empty()) {
+      _index = std::make_shared<const GzipIndex>(std::move(index.value()));
+    } else {
+      ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+      _inflater = std::make_unique<GzipInflater>(_fd, _compressed_size, _chunk_size);
+    }
+  }
+
+  ~GzipReader() {
+    _inflater.reset();
+    if (_fd != -1) {
+      ::close(_fd);
+    }
+  }
+
+  /// not copyable
+  GzipReader(const GzipReader&) = delete;
+  GzipReader& operator=(const GzipReader&) = delete;
+
+  /// movable: the file descriptor and the inflate state are handed over to the new reader
+  GzipReader(GzipReader&& other) noexcept
+      : _file_path(std::move(other._file_path)),
+        _index_path(std::move(other._index_path)),
+        _chunk_size(other._chunk_size),
+        _save_index(other._save_index),
+        _fd(std::exchange(other._fd, -1)),
+        _compressed_size(other._compressed_size),
+        _index(std::move(other._index)),
+        _next_point(other._next_point.load()),
+        _inflater(std::move(other._inflater)),
+        _tail(std::move(other._tail)),
+        _offset(other._offset),
+        _sequence_number(other._sequence_number),
+        _mutex(std::move(other._mutex)),
+        _buffer_pool(std::move(other._buffer_pool)) {}
+  GzipReader& operator=(GzipReader&&) = delete;
+
+  std::optional<T> operator()() override {
+    if (_index != nullptr) {
+      return read_region();
+    }
+    return read_sequential();
+  }
+
+  void recycle(T&& data) { _buffer_pool.release(std::move(data)); }
+
+  /// true if the file is read in parallel using an existing index
+  [[nodiscard]] bool has_index() const { return _index != nullptr; }
+
+ private:
+  std::optional<T> read_sequential() {
+    std::unique_lock lock(*_mutex);
+    if (_inflater == nullptr) {
+      return {};
+    }
+    T data = _buffer_pool.acquire();
+    _fill_newline_aligned(data, _tail, _chunk_size,
+                          [this](char* dest, size_t size) { return _inflater->read(dest, size); });
+    if (_inflater->done() && _tail.size() == 0) {
+      if (_save_index) {
+        try {
+          _inflater->index().save(_index_path);
+        } catch (const std::runtime_error&) {
+          // the index is an optimization only: the file is searched sequentially again next time
+        }
+      }
+      _inflater.reset();
+    }
+    if (data.size() == 0) {
+      _buffer_pool.release(std::move(data));
+      return {};
+    }
+    if constexpr (MutableOffsetDataC<T>) {
+      data.set_offset(_offset);
+    }
+    _offset += data.size();
+    _set_sequence_number(data, _sequence_number++);
+    return std::make_optional(std::move(data));
+  }
+
+  std::optional<T> read_region() {
+    const auto& points = _index->points();
+    size_t index = _next_point.fetch_add(1);
+    if (index >= points.size()) {
+      return {};
+    }
+    const auto& point = points[index];
+    uint64_t region_end = index + 1 < points.size() ? points[index + 1].out : _index->uncompressed_size();
+    size_t region_size = region_end - point.out;
+
+    GzipInflater inflater(_fd, _compressed_size, point);
+    T data = _buffer_pool.acquire();
+    data.resize(region_size);
+    size_t size = inflater.read(data.data(), region_size);
+
+    // first line starting at or after the checkpoint
+    size_t begin = 0;
+    if (point.out > 0 && (point.window.empty() || point.window.back() != '\n')) {
+      const char* new_line = search::simd::strchr(data.data(), size, '\n');
+      begin = new_line == nullptr ? size : new_line - data.data() + 1;
+    }
+    // begin == size: the region is part of a line started (and read) by a previous chunk. The empty chunk is
+    //  returned anyway to keep the sequence numbers gapless
+    if (begin < size && size == region_size && data[size - 1] != '\n') {
+      // first line starting at or after the end of the region
+      while (true) {
+        data.resize(size + line_probe_size);
+        size_t num_bytes = inflater.read(data.data() + size, line_probe_size);
+        const char* new_line = search::simd::strchr(data.data() + size, num_bytes, '\n');
+        if (new_line != nullptr) {
+          size = new_line - data.data() + 1;
+          break;
+        }
+        size += num_bytes;
+        if (num_bytes < line_probe_size) {
+          break;
+        }
+      }
+    }
+    if (begin > 0) {
+      std::memmove(data.data(), data.data() + begin, size - begin);
+    }
+    data.resize(size - begin);
+    if constexpr (MutableOffsetDataC<T>) {
+      data.set_offset(point.out + begin);
+    }
+    _set_sequence_number(data, index);
+    return std::make_optional(std::move(data));
+  }
+
+  static constexpr size_t line_probe_size = 1 << 16;
+
+  std::string _file_path;
+  std::string _index_path;
+  size_t _chunk_size;
+  bool _save_index;
+  int _fd = -1;
+  uint64_t _compressed_size = 0;
+
+  // parallel mode
+  std::shared_ptr<const GzipIndex> _index;
+  std::atomic<size_t> _next_point{0};
+
+  // sequential mode (builds the index)
+  std::unique_ptr<GzipInflater> _inflater;
+  T _tail;
+  uint64_t _offset = 0;
+  uint64_t _sequence_number = 0;
+  std::unique_ptr<std::mutex> _mutex;
+
+  utils::BufferPool<T> _buffer_pool;
+};
+
+/**
+ * Reads gzip files in parallel without index (c.f. xs::SpeculativeInflater): the search threads inflate chunks of
+ *  about chunk_size compressed bytes concurrently, starting at guessed deflate block boundaries.
+ *
+ * A chunk can be resolved (placeholders replaced, c.f. SpeculativeInflater::resolve()) once the chunks preceding it
+ *  are: after inflating a chunk, the thread waits until the preceding chunks have been resolved. Only the last 32 KiB
+ *  (the window the next chunk depends on) are resolved in order, the rest of the chunk is resolved concurrently.
+ *  Chunks that turned out to start at a false positive block boundary are skipped.
+ *
+ * Chunks are newline-aligned: the incomplete last line of a chunk is moved to the next one. Chunks carry their global
+ *  (uncompressed) offsets if T provides set_offset().
+ */
+template <ResizableDataC T = xs::DataChunk>
+class ParallelGzipReader : Reader_I<T> {
+ public:
+  static constexpr bool concurrent_access = true;
+
+  explicit ParallelGzipReader(std::string file_path, size_t chunk_size = 1 << 22, size_t max_pooled_buffers = 64)
+      : _file_path(std::move(file_path)), _state(std::make_unique<State>(max_pooled_buffers)) {
+    int fd = ::open(_file_path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      throw std::runtime_error("ParallelGzipReader: cannot open '" + _file_path + "': " + std::strerror(errno));
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) == -1) {
+      ::close(fd);
+      throw std::runtime_error("ParallelGzipReader: cannot stat '" + _file_path + "': " + std::strerror(errno));
+    }
+    _state->size = static_cast<size_t>(st.st_size);
+    if (_state->size > 0) {
+      void* addr = ::mmap(nullptr, _state->size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("ParallelGzipReader: cannot map '" + _file_path + "': " + std::strerror(errno));
+      }
+      _state->data = static_cast<const char*>(addr);
+    }
+    ::close(fd);
+    _state->inflater = std::make_unique<SpeculativeInflater>(_state->data, _state->size, chunk_size);
+  }
+
+  std::optional<T> operator()() override {
+    State& state = *_state;
+    const size_t num_chunks = state.inflater->num_chunks();
+    while (true) {
+      size_t k = state.next_chunk.fetch_add(1);
+      if (k >= num_chunks) {
+        return {};
+      }
+      SpeculativeInflater::Chunk chunk;
+      std::exception_ptr error;
+      try {
+        chunk = state.inflater->inflate(k);
+      } catch (const std::runtime_error&) {
+        error = std::current_exception();
+      }
+
+      std::unique_lock lock(state.mutex);
+      state.settled_cv.wait(lock, [&state, k]() { return state.settled == k; });
+      state.settled++;
+      if (k != state.next_reached || state.failed) {
+        // false positive chunk start: the data was inflated by a preceding chunk
+        state.settled_cv.notify_all();
+        continue;
+      }
+      if (error) {
+        state.failed = true;
+        state.settled_cv.notify_all();
+        std::rethrow_exception(error);
+      }
+      // the chunk is settled already: if resolving it throws, fail the search instead of leaving the threads waiting
+      // for the following chunks blocked
+      struct FailGuard {
+        State& state;
+        bool active = true;
+        ~FailGuard() {
+          if (active) {
+            state.failed = true;
+            state.settled_cv.notify_all();
+          }
+        }
+      } fail_guard{state};
+
+      const auto& symbols = chunk.symbols;
+      const size_t size = symbols.size();
+      std::string window = std::move(state.window);
+      T data = state.buffer_pool.acquire();
+      data.resize(state.carry.size() + size);
+      std::memcpy(data.data(), state.carry.data(), state.carry.size());
+      char* dest = data.data() + state.carry.size();
+      // the last 32 KiB are resolved first: they are the window of the next chunk
+      size_t tail_begin = size > SpeculativeInflater::window_size ? size - SpeculativeInflater::window_size : 0;
+      SpeculativeInflater::resolve(symbols.data() + tail_begin, size - tail_begin, window, dest + tail_begin);
+      size_t resolved_begin = tail_begin;
+      size_t end = size;
+      if (chunk.next_chunk < num_chunks) {
+        const char* new_line = search::simd::strrchr(dest + tail_begin, size - tail_begin, '\n');
+        if (new_line == nullptr && tail_begin > 0) {
+          SpeculativeInflater::resolve(symbols.data(), tail_begin, window, dest);
+          resolved_begin = 0;
+          new_line = search::simd::strrchr(dest, tail_begin, '\n');
+        }
+        end = new_line == nullptr ? 0 : new_line - dest + 1;
+      }
+      size_t num_bytes = end > 0 ? state.carry.size() + end : 0;
+      uint64_t offset = state.offset;
+      // chunks are settled in order: number the non-empty ones
+      uint64_t sequence_number = num_bytes > 0 ? state.next_sequence_number++ : 0;
+
+      if (size >= SpeculativeInflater::window_size) {
+        state.window.assign(dest + size - SpeculativeInflater::window_size, SpeculativeInflater::window_size);
+      } else {
+        size_t keep = std::min(window.size(), SpeculativeInflater::window_size - size);
+        state.window.assign(window, window.size() - keep, keep);
+        state.window.append(dest, size);
+      }
+      state.carry.assign(data.data() + num_bytes, data.size() - num_bytes);
+      state.offset += num_bytes;
+      state.next_reached = chunk.next_chunk;
+      state.settled_cv.notify_all();
+      fail_guard.active = false;
+      lock.unlock();
+
+      if (num_bytes == 0) {
+        // no new line char: the whole chunk was moved to the next one
+        state.buffer_pool.release(std::move(data));
+        continue;
+      }
+      SpeculativeInflater::resolve(symbols.data(), resolved_begin, window, dest);
+      data.resize(num_bytes);
+      if constexpr (MutableOffsetDataC<T>) {
+        data.set_offset(offset);
+      }
+      _set_sequence_number(data, sequence_number);
+      return std::make_optional(std::move(data));
+    }
+  }
+
+  void recycle(T&& data) { _state->buffer_pool.release(std::move(data)); }
+
+  /// number of chunks the compressed data is split into
+  [[nodiscard]] size_t num_chunks() const { return _state->inflater->num_chunks(); }
+
+ private:
+  // kept behind a pointer: the reader stays movable
+  struct State {
+    explicit State(size_t max_pooled_buffers) : buffer_pool(max_pooled_buffers) {}
+    ~State() {
+      inflater.reset();
+      if (data != nullptr) {
+        ::munmap(const_cast<char*>(data), size);
+      }
+    }
+
+    const char* data = nullptr;
+    size_t size = 0;
+    std::unique_ptr<SpeculativeInflater> inflater;
+    std::atomic<size_t> next_chunk{0};
+
+    std::mutex mutex;
+    std::condition_variable settled_cv;
+    /// chunks [0, settled) were resolved or skipped
+    size_t settled = 0;
+    /// the next chunk that is part of the data
+    size_t next_reached = 0;
+    bool failed = false;
+    /// the last 32 KiB of the data resolved so far
+    std::string window;
+    /// incomplete last line of the data resolved so far and its global offset
+    std::string carry;
+    uint64_t offset = 0;
+    uint64_t next_sequence_number = 0;
+
+    utils::BufferPool<T> buffer_pool;
+  };
+
+  std::string _file_path;
+  std::unique_ptr<State> _state;
+};
+
+/**
+ * Reads a compressed file sequentially (c.f. xs::StreamDecoder) into newline-aligned chunks. The fallback for
+ *  compressed files that cannot be decompressed in parallel: only searching is parallelized.
+ */
+template <ResizableDataC T = xs::DataChunk>
+class DecompressingReader : Reader_I<T> {
+ public:
+  DecompressingReader(std::string file_path, FileFormat format, size_t chunk_size = 524288,
+                      size_t max_pooled_buffers = 64)
+      : _file_path(std::move(file_path)), _chunk_size(chunk_size), _buffer_pool(max_pooled_buffers) {
+    _fd = ::open(_file_path.c_str(), O_RDONLY);
+    if (_fd == -1) {
+      throw std::runtime_error("DecompressingReader: cannot open '" + _file_path + "': " + std::strerror(errno));
+    }
+    ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    try {
+      _decoder = StreamDecoder::create(format, _fd);
+    } catch (...) {
+      ::close(_fd);
+      throw;
+    }
+  }
+
+  ~DecompressingReader() {
+    _decoder.reset();
+    if (_fd != -1) {
+      ::close(_fd);
+    }
+  }
+
+  /// not copyable
+  DecompressingReader(const DecompressingReader&) = delete;
+  DecompressingReader& operator=(const DecompressingReader&) = delete;
+
+  /// movable: the file descriptor and the decoder are handed over to the new reader
+  DecompressingReader(DecompressingReader&& other) noexcept
+      : _file_path(std::move(other._file_path)),
+        _chunk_size(other._chunk_size),
+        _fd(std::exchange(other._fd, -1)),
+        _decoder(std::move(other._decoder)),
+        _offset(other._offset),
+        _sequence_number(other._sequence_number),
+        _tail(std::move(other._tail)),
+        _buffer_pool(std::move(other._buffer_pool)) {}
+  DecompressingReader& operator=(DecompressingReader&&) = delete;
+
+  std::optional<T> operator()() override {
+    if (_decoder == nullptr) {
+      return {};
+    }
+    T data = _buffer_pool.acquire();
+    bool eof = false;
+    _fill_newline_aligned(data, _tail, _chunk_size, [this, &eof](char* dest, size_t size) {
+      size_t num_bytes = _decoder->read(dest, size);
+      eof = eof || num_bytes < size;
+      return num_bytes;
+    });
+    if (eof && _tail.size() == 0) {
+      _decoder.reset();
+    }
+    if (data.size() == 0) {
+      _buffer_pool.release(std::move(data));
+      return {};
+    }
+    if constexpr (MutableOffsetDataC<T>) {
+      data.set_offset(_offset);
+    }
+    _offset += data.size();
+    _set_sequence_number(data, _sequence_number++);
+    return std::make_optional(std::move(data));
+  }
+
+  void recycle(T&& data) { _buffer_pool.release(std::move(data)); }
+
+ private:
+  std::string _file_path;
+  size_t _chunk_size;
+  int _fd = -1;
+  std::unique_ptr<StreamDecoder> _decoder;
+  uint64_t _offset = 0;
+  uint64_t _sequence_number = 0;
+  T _tail;
+  utils::BufferPool<T> _buffer_pool;
+};
+
+/**
+ * Reads the regular file members of a tar archive (plain or compressed, c.f. xs::TarStream) without extracting them:
+ *  the archive is streamed once and the member payloads are packed into newline-aligned chunks of about chunk_size
+ *  bytes. Small members are batched into one chunk, large members are split at line boundaries.
+ *
+ * Each chunk records which of its bytes belong to which member (c.f. xs::MultiFileChunk::segments()); the file
+ *  offsets of the segments are relative to the member. Members are identified by their index in members(); search them
+ *  using xs::MultiFileSearcher. Reading is sequential, searching the chunks is parallel.
+ */
+template <ResizableDataC T = xs::MultiFileChunk>
+class TarReader : Reader_I<T> {
+ public:
+  explicit TarReader(const std::string& file_path, size_t chunk_size = 524288, size_t max_pooled_buffers = 64)
+      : _chunk_size(std::max<size_t>(1, chunk_size)),
+        _stream(std::make_unique<TarStream>(file_path)),
+        _members(std::make_shared<std::vector<std::string>>()),
+        _buffer_pool(max_pooled_buffers) {}
+
+  /// not copyable
+  TarReader(const TarReader&) = delete;
+  TarReader& operator=(const TarReader&) = delete;
+
+  TarReader(TarReader&& other) noexcept
+      : _chunk_size(other._chunk_size),
+        _stream(std::move(other._stream)),
+        _members(std::move(other._members)),
+        _member_id(other._member_id),
+        _member_offset(other._member_offset),
+        _sequence_number(other._sequence_number),
+        _carry(std::move(other._carry)),
+        _buffer_pool(std::move(other._buffer_pool)) {}
+  TarReader& operator=(TarReader&&) = delete;
+
+  std::optional<T> operator()() override {
+    if (_stream == nullptr) {
+      return {};
+    }
+    T data = _buffer_pool.acquire();
+    data.segments().clear();
+    data.resize(0);
+    while (data.size() < _chunk_size) {
+      if (_stream->remaining() == 0 && _carry.empty() && !next_member()) {
+        _stream.reset();
+        break;
+      }
+      size_t begin = data.size();
+      uint64_t file_offset = _member_offset - _carry.size();
+      data.resize(begin + _carry.size());
+      std::memcpy(data.data() + begin, _carry.data(), _carry.size());
+      _carry.clear();
+      read(data, std::min<uint64_t>(_stream->remaining(), _chunk_size - std::min(_chunk_size, data.size())));
+      if (_stream->remaining() > 0) {
+        // the chunk is full: cut it after the last complete line of the member
+        size_t search_begin = begin;
+        while (!cut(data, search_begin)) {
+          if (begin > 0) {
+            // no complete line: the member starts the next chunk
+            _carry.assign(data.data() + begin, data.size() - begin);
+            data.resize(begin);
+            break;
+          }
+          // a single line exceeding the chunk size: extend the chunk until its end
+          search_begin = data.size();
+          read(data, std::min<uint64_t>(_stream->remaining(), _chunk_size));
+          if (_stream->remaining() == 0) {
+            break;
+          }
+        }
+      }
+      if (data.size() > begin) {
+        data.segments().push_back({_member_id, begin, data.size() - begin, file_offset});
+      }
+      if (_stream->remaining() > 0 || !_carry.empty()) {
+        break;
+      }
+    }
+    if (data.segments().empty()) {
+      _buffer_pool.release(std::move(data));
+      return {};
+    }
+    _set_sequence_number(data, _sequence_number++);
+    return std::make_optional(std::move(data));
+  }
+
+  void recycle(T&& data) { _buffer_pool.release(std::move(data)); }
+
+  /**
+   * The paths of the members read so far, indexed by the file ids of the chunk segments. Members are discovered while
+   *  reading, so the list is complete once the search finished. Shared, so that it stays available after the reader
+   *  was moved into an xs::Searcher.
+   */
+  [[nodiscard]] std::shared_ptr<const std::vector<std::string>> members() const { return _members; }
+
+ private:
+  /// advance to the next member with a non-empty payload, false at the end of the archive
+  bool next_member() {
+    while (auto member = _stream->next_member()) {
+      _members->push_back(std::move(member->path));
+      if (member->size > 0) {
+        _member_id = _members->size() - 1;
+        _member_offset = 0;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// append size bytes of the current member to data
+  void read(T& data, size_t size) {
+    size_t position = data.size();
+    data.resize(position + size);
+    _stream->read(data.data() + position, size);
+    _member_offset += size;
+  }
+
+  /// move the bytes after the last newline at or after search_begin to the carry, false if there is none
+  bool cut(T& data, size_t search_begin) {
+    auto* newline = static_cast<char*>(memrchr(data.data() + search_begin, '\n', data.size() - search_begin));
+    if (newline == nullptr) {
+      return false;
+    }
+    size_t end = static_cast<size_t>(newline - data.data()) + 1;
+    _carry.assign(data.data() + end, data.size() - end);
+    data.resize(end);
+    return true;
+  }
+
+  size_t _chunk_size;
+  std::unique_ptr<TarStream> _stream;
+  std::shared_ptr<std::vector<std::string>> _members;
+  uint64_t _member_id = 0;
+  /// number of payload bytes of the current member read from the archive
+  uint64_t _member_offset = 0;
+  uint64_t _sequence_number = 0;
+  /// incomplete last line of the previous chunk (part of the current member)
+  std::string _carry;
+  utils::BufferPool<T> _buffer_pool;
+};
+
+/**
+ * Options of xs::AutoReader.
+ */
+struct AutoReaderOptions {
+  /// size of chunks read from files that were not split by preprocessing
+  size_t chunk_size = 1 << 22;
+  /// meta file of files split by preprocessing (c.f. xs::MetaFile), default: <file_path>.meta
+  std::string meta_file_path;
+  /// checkpoint index of gzip files (c.f. xs::GzipReader), default: <file_path>.xsgzi
+  std::string gzip_index_path;
+  /// gzip files without index are read sequentially, building the index, instead of speculatively in parallel
+  bool build_gzip_index = false;
+};
+
+/**
+ * Front door for searching files of any supported format: the format is determined at runtime and the fastest
+ *  available reader is used:
+ *  - meta file present (c.f. xs::preprocess()): ChunkReader, LZ4ChunkReader, ZstdChunkReader or MixedChunkReader
+ *    (parallel)
+ *  - gzip with checkpoint index: GzipReader (parallel)
+ *  - gzip without index: ParallelGzipReader (parallel) or GzipReader (sequential, builds the index)
+ *  - ZSTD or LZ4 frame: DecompressingReader (sequential)
+ *  - anything else: PReadFileReader (parallel)
+ *
+ * Sequential readers are serialized internally, so the reader may always be called by multiple threads concurrently.
+ */
+template <ResizableDataC T = xs::DataChunk>
+class AutoReader : Reader_I<T> {
+ public:
+  static constexpr bool concurrent_access = true;
+
+  explicit AutoReader(const std::string& file_path, const AutoReaderOptions& options = {})
+      : _mutex(std::make_unique<std::mutex>()) {
+    std::string meta_file_path = options.meta_file_path.empty() ? file_path + ".meta" : options.meta_file_path;
+    if (std::filesystem::exists(meta_file_path)) {
+      switch (MetaFile(meta_file_path, std::ios::in).get_compression_type()) {
+        case CompressionType::NONE:
+          _reader = std::make_unique<ChunkReader<T>>(file_path, meta_file_path);
+          return;
+        case CompressionType::LZ4:
+          _reader = std::make_unique<LZ4ChunkReader<T>>(file_path, meta_file_path);
+          return;
+        case CompressionType::ZSTD:
+          _reader = std::make_unique<ZstdChunkReader<T>>(file_path, meta_file_path);
+          return;
+        case CompressionType::MIXED:
+          _reader = std::make_unique<MixedChunkReader<T>>(file_path, meta_file_path);
+          return;
+        default:
+          throw std::runtime_error("AutoReader: unsupported compression type in '" + meta_file_path + "'");
+      }
+    }
+    _format = detect_format(file_path);
+    switch (_format) {
+      case FileFormat::GZIP: {
+        auto reader = std::make_unique<GzipReader<T>>(file_path, options.chunk_size, options.gzip_index_path);
+        if (reader->has_index() || options.build_gzip_index) {
+          _parallel = reader->has_index();
+          _reader = std::move(reader);
+        } else {
+          reader.reset();
+          _reader = std::make_unique<ParallelGzipReader<T>>(file_path, options.chunk_size);
+        }
+        return;
+      }
+      case FileFormat::ZSTD:
+      case FileFormat::LZ4_FRAME:
+        _reader = std::make_unique<DecompressingReader<T>>(file_path, _format, options.chunk_size);
+        _parallel = false;
+        return;
+      default:
+        _reader = std::make_unique<PReadFileReader<T>>(file_path, options.chunk_size, true);
+    }
+  }
+
+  std::optional<T> operator()() override {
+    return std::visit(
+        [this](auto& reader) -> std::optional<T> {
+          if constexpr (ConcurrentReaderC<std::decay_t<decltype(*reader)>>) {
+            return (*reader)();
+          } else {
+            std::unique_lock lock(*_mutex);
+            return (*reader)();
+          }
+        },
+        _reader);
+  }
+
+  /// handed on to the selected reader (serialized unless it is a ConcurrentReaderC)
+  void recycle(T&& data) {
+    std::visit(
+        [this, &data](auto& reader) {
+          if constexpr (ConcurrentReaderC<std::decay_t<decltype(*reader)>>) {
+            reader->recycle(std::move(data));
+          } else {
+            std::unique_lock lock(*_mutex);
+            reader->recycle(std::move(data));
+          }
+        },
+        _reader);
+  }
+
+  /// format detected by the magic bytes of the file (PLAIN for files read using their meta file)
+  [[nodiscard]] FileFormat format() const { return _format; }
+
+  /// true if the file is read by multiple threads in parallel
+  [[nodiscard]] bool parallel() const { return _parallel; }
+
+ private:
+  std::variant<std::unique_ptr<PReadFileReader<T>>, std::unique_ptr<ChunkReader<T>>,
+               std::unique_ptr<LZ4ChunkReader<T>>, std::unique_ptr<ZstdChunkReader<T>>,
+               std::unique_ptr<MixedChunkReader<T>>, std::unique_ptr<GzipReader<T>>, std::unique_ptr<ParallelGzipReader<T>>,
+               std::unique_ptr<DecompressingReader<T>>>
+      _reader;
+  FileFormat _format = FileFormat::PLAIN;
+  bool _parallel = true;
+  std::unique_ptr<std::mutex> _mutex;
 };
 
 }  // namespace xs
\ No newline at end of file
@@ -14,9 +14,24 @@
 #include <functional>
 #include <optional>
 #include <string>
+#include <tuple>
+#include <type_traits>
 
 namespace xs {
 
+/**
+ * Byte offsets found by the search tasks are relative to the start of the searched chunk. If the chunk knows where it
+ *  is located within its source (c.f. OffsetDataC), they are shifted to global byte offsets.
+ */
+template <DefaultDataC T>
+void to_global_offsets(const T& data, PartRes1<uint64_t>& offsets) {
+  if constexpr (OffsetDataC<T>) {
+    for (auto& offset : offsets) {
+      offset += data.offset();
+    }
+  }
+}
+
 /**
  *
  * @tparam R
@@ -51,6 +66,7 @@ class IndexSearcher : Searcher_I<PartRes1<size_t>, T> {
     if (match_indices.empty()) {
       return {};
     }
+    to_global_offsets(data, match_indices);
     return std::make_optional(std::move(match_indices));
   }
 
@@ -68,6 +84,7 @@ class LineIndexSearcher : Searcher_I<PartRes1<uint64_t>, T> {
     if (match_indices.empty()) {
       return {};
     }
+    to_global_offsets(data, match_indices);
     return std::make_optional(std::move(match_indices));
   }
 
@@ -92,4 +109,43 @@ class LineSearcher : Searcher_I<PartRes1<std::string>, T> {
   std::string _pattern;
 };
 
+/**
+ * Searches the chunks of xs::MultiFileReader (or xs::TarReader): the inner searcher (e.g. LineIndexSearcher<DataView>)
+ *  is run on every file segment of a chunk separately, so that matches never span two files and offsets are relative
+ *  to the file. Every result of the inner searcher is tagged with the id of the file it was found in (c.f.
+ *  MultiFileReader::files(), TarReader::members()).
+ *
+ * @tparam SearcherT searcher of xs::DataView
+ * @tparam T chunk type providing segments() (c.f. xs::MultiFileChunk)
+ */
+template <typename SearcherT, DefaultDataC T = MultiFileChunk>
+class MultiFileSearcher {
+  using inner_result = typename std::invoke_result_t<const SearcherT&, const DataView&>::value_type;
+
+ public:
+  using result_type = PartRes2<uint64_t, typename inner_result::value_type>;
+
+  explicit MultiFileSearcher(SearcherT searcher) : _searcher(std::move(searcher)) {}
+
+  std::optional<result_type> operator()(const T& data) const {
+    result_type results;
+    for (const auto& segment : data.segments()) {
+      auto segment_results = _searcher(DataView(data.data() + segment.begin, segment.size, segment.file_offset));
+      if (!segment_results) {
+        continue;
+      }
+      for (auto& result : *segment_results) {
+        results.emplace_back(segment.file_id, std::move(result));
+      }
+    }
+    if (results.empty()) {
+      return {};
+    }
+    return std::make_optional(std::move(results));
+  }
+
+ private:
+  SearcherT _searcher;
+};
+
 }  // namespace xs
\ No newline at end of file
@@ -7,12 +7,146 @@
 
 #pragma once
 
-//#include <xsearch/utils/UninitializedAllocator.h>
+#include <xsearch/utils/UninitializedAllocator.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 namespace xs {
 
-using strtype = std::vector<char>; //, uninit_allocator<char>>;
+using strtype = std::vector<char, uninit_allocator<char>>;
 
-}
\ No newline at end of file
+/**
+ * Owning chunk of data that knows where it is located within its source: readers that do not hand out chunks in file
+ *  order (e.g. xs::PReadFileReader) set the offset, so that search tasks can report global byte offsets.
+ */
+template <typename Allocator>
+class BasicDataChunk : public std::vector<char, Allocator> {
+ public:
+  using std::vector<char, Allocator>::vector;
+
+  /// byte offset of the first byte of the chunk within the source (e.g. the file) it was read from
+  [[nodiscard]] uint64_t offset() const { return _offset; }
+  void set_offset(uint64_t offset) { _offset = offset; }
+
+  /**
+   * Position of the chunk within its source (0, 1, 2, ... without gaps), so that results of chunks that were searched
+   *  out of order can be put back into source order (c.f. xs::OrderedResult).
+   */
+  [[nodiscard]] uint64_t sequence_number() const { return _sequence_number; }
+  void set_sequence_number(uint64_t sequence_number) { _sequence_number = sequence_number; }
+
+ private:
+  uint64_t _offset = 0;
+  uint64_t _sequence_number = 0;
+};
+
+using DataChunk = BasicDataChunk<strtype::allocator_type>;
+
+/// DataChunk whose buffer is aligned to 4096 bytes as required for O_DIRECT reads
+using AlignedDataChunk = BasicDataChunk<aligned_uninit_allocator<char, 4096>>;
+
+/// a line starts at globalByteOffset, it is the globalLineIndex-th line of the (uncompressed) file
+struct ByteToNewLineMappingInfo {
+  uint64_t globalByteOffset = 0;
+  uint64_t globalLineIndex = 0;
+
+  bool operator==(const ByteToNewLineMappingInfo&) const = default;
+};
+
+/**
+ * DataChunk carrying the line mapping data of its chunk meta data (c.f. xs::MetaFile), so that global line indices can
+ *  be computed without counting the lines of all preceding chunks. The mapping data of a chunk starts at its first
+ *  byte.
+ */
+class LineMappedDataChunk : public DataChunk {
+ public:
+  using DataChunk::DataChunk;
+
+  [[nodiscard]] const std::vector<ByteToNewLineMappingInfo>& line_mapping_data() const { return _line_mapping_data; }
+  void set_line_mapping_data(std::vector<ByteToNewLineMappingInfo> line_mapping_data) {
+    _line_mapping_data = std::move(line_mapping_data);
+  }
+
+  /**
+   * Global index of the line containing the byte at global_byte_offset (which must lie within this chunk): new line
+   *  chars are only counted from the closest preceding mapping point on.
+   */
+  [[nodiscard]] uint64_t line_index(uint64_t global_byte_offset) const {
+    auto it = std::upper_bound(_line_mapping_data.begin(), _line_mapping_data.end(), global_byte_offset,
+                               [](uint64_t offset, const ByteToNewLineMappingInfo& info) {
+                                 return offset < info.globalByteOffset;
+                               });
+    uint64_t line_index = 0;
+    uint64_t begin = offset();
+    if (it != _line_mapping_data.begin()) {
+      --it;
+      line_index = it->globalLineIndex;
+      begin = it->globalByteOffset;
+    }
+    return line_index + std::count(this->data() + (begin - offset()), this->data() + (global_byte_offset - offset()),
+                                   '\n');
+  }
+
+ private:
+  std::vector<ByteToNewLineMappingInfo> _line_mapping_data;
+};
+
+/**
+ * Chunk holding data of several files (c.f. xs::MultiFileReader): small files are batched into one chunk, large files
+ *  are split into several chunks. The segments describe which bytes of the chunk belong to which file.
+ */
+class MultiFileChunk : public DataChunk {
+ public:
+  struct Segment {
+    /// index of the file within the file list of the reader
+    uint64_t file_id = 0;
+    /// position of the first byte of the segment within the chunk
+    size_t begin = 0;
+    size_t size = 0;
+    /// byte offset of the first byte of the segment within its file
+    uint64_t file_offset = 0;
+  };
+
+  using DataChunk::DataChunk;
+
+  [[nodiscard]] const std::vector<Segment>& segments() const { return _segments; }
+  std::vector<Segment>& segments() { return _segments; }
+
+ private:
+  std::vector<Segment> _segments;
+};
+
+/**
+ * Non-owning view on a chunk of data.
+ *  The viewed memory is owned by someone else (e.g. the mapping of xs::MmapFileReader) and must outlive the view.
+ */
+class DataView {
+ public:
+  DataView() = default;
+  DataView(const char* data, size_t size, uint64_t offset = 0, uint64_t sequence_number = 0)
+      : _data(data), _size(size), _offset(offset), _sequence_number(sequence_number) {}
+
+  [[nodiscard]] const char* data() const { return _data; }
+  [[nodiscard]] size_t size() const { return _size; }
+  [[nodiscard]] bool empty() const { return _size == 0; }
+
+  /// byte offset of the first viewed byte within the source (e.g. the file) the view was taken from
+  [[nodiscard]] uint64_t offset() const { return _offset; }
+
+  /// position of the view within its source (c.f. BasicDataChunk::sequence_number())
+  [[nodiscard]] uint64_t sequence_number() const { return _sequence_number; }
+
+  [[nodiscard]] const char* begin() const { return _data; }
+  [[nodiscard]] const char* end() const { return _data + _size; }
+
+ private:
+  const char* _data = nullptr;
+  size_t _size = 0;
+  uint64_t _offset = 0;
+  uint64_t _sequence_number = 0;
+};
+
+}
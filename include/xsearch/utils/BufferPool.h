@@ -0,0 +1,74 @@
+/**
+ * Copyright 2023, Leon Freist (https://github.com/lfreist)
+ * Author: Leon Freist <freist.leon@gmail.com>
+ *
+ * This file is part of x-search.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace xs::utils {
+
+/**
+ * Bounded, thread safe pool of reusable buffers (e.g. chunk buffers of a reader).
+ *  Buffers that were handed out using acquire() can be given back using release(). Their memory is then reused by
+ *  subsequent calls of acquire() instead of allocating new buffers. At most max_size buffers are kept, buffers that
+ *  are released into a full pool are freed.
+ *
+ * @tparam T - buffer type (e.g. xs::strtype)
+ */
+template <typename T>
+class BufferPool {
+ public:
+  explicit BufferPool(size_t max_size = 64) : _max_size(max_size), _mutex(std::make_unique<std::mutex>()) {}
+  ~BufferPool() = default;
+
+  /// not copyable
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+
+  /// movable
+  BufferPool(BufferPool&&) noexcept = default;
+  BufferPool& operator=(BufferPool&&) noexcept = default;
+
+  /**
+   * Take a buffer out of the pool. If the pool is empty, a new default constructed buffer is returned.
+   *  The content of a reused buffer is left as it is.
+   */
+  T acquire() {
+    std::unique_lock lock(*_mutex);
+    if (_buffers.empty()) {
+      return T();
+    }
+    T buffer = std::move(_buffers.back());
+    _buffers.pop_back();
+    return buffer;
+  }
+
+  /**
+   * Give a buffer back to the pool. The buffer is dropped if the pool is full already.
+   */
+  void release(T&& buffer) {
+    std::unique_lock lock(*_mutex);
+    if (_buffers.size() < _max_size) {
+      _buffers.push_back(std::move(buffer));
+    }
+  }
+
+  /// number of buffers currently held by the pool
+  size_t size() const {
+    std::unique_lock lock(*_mutex);
+    return _buffers.size();
+  }
+
+ private:
+  size_t _max_size;
+  std::vector<T> _buffers;
+  std::unique_ptr<std::mutex> _mutex;
+};
+
+}  // namespace xs::utils
@@ -0,0 +1,199 @@
+/**
+ * Copyright 2023, Leon Freist (https://github.com/lfreist)
+ * Author: Leon Freist <freist.leon@gmail.com>
+ *
+ * This file is part of x-search.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace xs::utils {
+
+/**
+ * Adapts the chunk size of a reader while a scan is running.
+ *
+ * The reader reports the read latency of every chunk (record_read()), the search threads report the search time and
+ *  the number of results of every chunk (record_search()). Samples are aggregated into epochs of epoch_length chunks.
+ *  After each epoch the throughput of the pipeline is estimated from the averages: with reads serialized and
+ *  num_threads threads that each read and then search a chunk, a chunk of S bytes that takes R to read and P to search
+ *  yields
+ *    throughput = S / max(R, (R + P) / num_threads)
+ *  i.e. the reader is the bottleneck if num_threads * R > R + P, otherwise the workers are. Per chunk overheads (system
+ *  calls, thread handoff, building results) favour large chunks, cache misses in the search of chunks that do not
+ *  fit into the cache favour small chunks. Both show up in the measured R and P.
+ *
+ * The chunk size is hill-climbed in factors of two within [min_chunk_size, max_chunk_size]: the first step goes up if
+ *  the reader is the bottleneck and down otherwise. A step is kept if it improves the throughput by more than
+ *  tolerance, otherwise the tuner returns to the best size and tries the other direction once. Afterwards it has
+ *  converged and keeps the best size.
+ *
+ * All functions are thread safe.
+ */
+class ChunkSizeTuner {
+ public:
+  using duration = std::chrono::nanoseconds;
+
+  /// aggregated measurements of one epoch
+  struct Epoch {
+    size_t chunk_size = 0;
+    uint64_t num_chunks = 0;
+    /// average bytes, read and search time (ns) and number of results per chunk
+    double bytes = 0;
+    double read_ns = 0;
+    double search_ns = 0;
+    double num_results = 0;
+    /// estimated throughput in bytes per second
+    double throughput = 0;
+  };
+
+  ChunkSizeTuner(size_t initial_chunk_size, size_t num_threads, size_t min_chunk_size = 1 << 16,
+                 size_t max_chunk_size = 1 << 24, size_t epoch_length = 16, double tolerance = 0.05)
+      : _min_chunk_size(std::max<size_t>(1, min_chunk_size)),
+        _max_chunk_size(std::max(_min_chunk_size, max_chunk_size)),
+        _num_threads(std::max<size_t>(1, num_threads)),
+        _epoch_length(std::max<size_t>(1, epoch_length)),
+        _tolerance(tolerance),
+        _chunk_size(std::clamp(initial_chunk_size, _min_chunk_size, _max_chunk_size)) {}
+
+  /// the chunk size the reader should use for its next read
+  [[nodiscard]] size_t chunk_size() const {
+    std::unique_lock lock(_mutex);
+    return _chunk_size;
+  }
+
+  /// true once the tuner settled on a chunk size
+  [[nodiscard]] bool converged() const {
+    std::unique_lock lock(_mutex);
+    return _converged;
+  }
+
+  /// all completed epochs in chronological order: the chunk size chosen over time and the measurements behind it
+  [[nodiscard]] std::vector<Epoch> history() const {
+    std::unique_lock lock(_mutex);
+    return _history;
+  }
+
+  /// a chunk of num_bytes was read within read_time
+  void record_read(size_t num_bytes, duration read_time) {
+    std::unique_lock lock(_mutex);
+    if (!is_current(num_bytes)) {
+      return;
+    }
+    _num_reads++;
+    _read_bytes += num_bytes;
+    _read_time += read_time;
+  }
+
+  /// a chunk of num_bytes was searched within search_time, producing num_results results
+  void record_search(size_t num_bytes, duration search_time, size_t num_results) {
+    std::unique_lock lock(_mutex);
+    if (!is_current(num_bytes)) {
+      return;
+    }
+    _num_searches++;
+    _search_time += search_time;
+    _num_results += num_results;
+    if (!_converged && _num_reads >= _epoch_length && _num_searches >= _epoch_length) {
+      finish_epoch();
+    }
+  }
+
+ private:
+  /**
+   * Samples of chunks that were read before the last change of the chunk size (still in flight) are ignored. Chunks
+   *  may be shorter (end of file) or somewhat longer (newline alignment) than the chunk size.
+   */
+  [[nodiscard]] bool is_current(size_t num_bytes) const {
+    return num_bytes * 2 >= _chunk_size && num_bytes <= _chunk_size * 2;
+  }
+
+  void finish_epoch() {
+    Epoch epoch;
+    epoch.chunk_size = _chunk_size;
+    epoch.num_chunks = _num_reads;
+    epoch.bytes = static_cast<double>(_read_bytes) / static_cast<double>(_num_reads);
+    epoch.read_ns = static_cast<double>(_read_time.count()) / static_cast<double>(_num_reads);
+    epoch.search_ns = static_cast<double>(_search_time.count()) / static_cast<double>(_num_searches);
+    epoch.num_results = static_cast<double>(_num_results) / static_cast<double>(_num_searches);
+    double cycle_ns = std::max(epoch.read_ns, (epoch.read_ns + epoch.search_ns) / static_cast<double>(_num_threads));
+    epoch.throughput = cycle_ns > 0 ? epoch.bytes * 1e9 / cycle_ns : 0;
+    _history.push_back(epoch);
+
+    _num_reads = 0;
+    _num_searches = 0;
+    _read_bytes = 0;
+    _num_results = 0;
+    _read_time = duration::zero();
+    _search_time = duration::zero();
+
+    if (_history.size() == 1) {
+      _best = epoch;
+      bool reader_bound = epoch.read_ns * static_cast<double>(_num_threads) > epoch.read_ns + epoch.search_ns;
+      _grow = reader_bound;
+      step(_chunk_size);
+      return;
+    }
+    if (epoch.throughput > _best.throughput * (1 + _tolerance)) {
+      _best = epoch;
+      step(_chunk_size);
+      return;
+    }
+    // no improvement: go back to the best size and try the other direction (once)
+    _chunk_size = _best.chunk_size;
+    if (_reversed) {
+      _converged = true;
+      return;
+    }
+    _reversed = true;
+    _grow = !_grow;
+    step(_chunk_size);
+  }
+
+  /// move one step from chunk_size in the current direction, converge if a bound is reached
+  void step(size_t chunk_size) {
+    size_t next = _grow ? std::min(_max_chunk_size, chunk_size * 2) : std::max(_min_chunk_size, chunk_size / 2);
+    if (next != chunk_size) {
+      _chunk_size = next;
+      return;
+    }
+    _chunk_size = _best.chunk_size;
+    if (_reversed) {
+      _converged = true;
+    } else {
+      _reversed = true;
+      _grow = !_grow;
+      step(_chunk_size);
+    }
+  }
+
+  size_t _min_chunk_size;
+  size_t _max_chunk_size;
+  size_t _num_threads;
+  size_t _epoch_length;
+  double _tolerance;
+
+  size_t _chunk_size;
+  bool _grow = true;
+  bool _reversed = false;
+  bool _converged = false;
+  Epoch _best;
+  std::vector<Epoch> _history;
+
+  // measurements of the current epoch
+  uint64_t _num_reads = 0;
+  uint64_t _num_searches = 0;
+  uint64_t _read_bytes = 0;
+  uint64_t _num_results = 0;
+  duration _read_time = duration::zero();
+  duration _search_time = duration::zero();
+
+  mutable std::mutex _mutex;
+};
+
+}  // namespace xs::utils
@@ -0,0 +1,84 @@
+/**
+ * Copyright 2023, Leon Freist (https://github.com/lfreist)
+ * Author: Leon Freist <freist.leon@gmail.com>
+ *
+ * This file is part of x-search.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace xs::utils {
+
+/**
+ * Minimal io_uring submission/completion ring (using the raw system calls, no liburing required).
+ *  Only supports what the readers need: queueing reads and reaping their completions.
+ *  Not thread safe: callers must synchronize access.
+ */
+class IoUring {
+ public:
+  struct Completion {
+    uint64_t user_data;
+    /// number of bytes read or -errno
+    int32_t result;
+  };
+
+  /**
+   * Set up a ring with (at least) the given number of submission queue entries.
+   *  Throws std::system_error if the kernel does not support io_uring (or it is not permitted).
+   */
+  explicit IoUring(unsigned entries);
+  ~IoUring();
+
+  /// not copyable/movable: the rings are shared with the kernel
+  IoUring(const IoUring&) = delete;
+  IoUring(IoUring&&) = delete;
+  IoUring& operator=(const IoUring&) = delete;
+  IoUring& operator=(IoUring&&) = delete;
+
+  /**
+   * Queue a read of size bytes of fd at offset into dest. The read is passed to the kernel with the next submit().
+   *
+   * @return false if the submission queue is full
+   */
+  bool prepare_read(int fd, char* dest, uint32_t size, uint64_t offset, uint64_t user_data);
+
+  /**
+   * Submit all queued reads and block until at least min_complete completions are available.
+   */
+  void submit(unsigned min_complete = 0);
+
+  /**
+   * Take the next available completion, if any (does not block).
+   */
+  std::optional<Completion> pop_completion();
+
+  [[nodiscard]] unsigned entries() const { return _sq_entries; }
+
+ private:
+  int _ring_fd = -1;
+  unsigned _sq_entries = 0;
+  unsigned _to_submit = 0;
+
+  void* _sq_ring = nullptr;
+  size_t _sq_ring_size = 0;
+  void* _cq_ring = nullptr;
+  size_t _cq_ring_size = 0;
+  void* _sqes = nullptr;
+  size_t _sqes_size = 0;
+
+  // pointers into the mapped rings
+  unsigned* _sq_head = nullptr;
+  unsigned* _sq_tail = nullptr;
+  unsigned* _sq_mask = nullptr;
+  unsigned* _sq_array = nullptr;
+  unsigned* _cq_head = nullptr;
+  unsigned* _cq_tail = nullptr;
+  unsigned* _cq_mask = nullptr;
+  void* _cqes = nullptr;
+};
+
+}  // namespace xs::utils
@@ -0,0 +1,129 @@
+/**
+ * Copyright 2023, Leon Freist (https://github.com/lfreist)
+ * Author: Leon Freist <freist.leon@gmail.com>
+ *
+ * This file is part of x-search.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace xs::utils {
+
+/**
+ * Adaptive read-ahead for sequential readers: keeps a window of upcoming chunks prefetched into the page cache
+ *  (posix_fadvise(POSIX_FADV_WILLNEED)) so that the latency of the device overlaps with searching the current chunks.
+ *
+ * The window (in chunks) adapts to the measured consumer speed:
+ *  - a read that stalls, i.e. takes longer than stall_ratio times the time the consumers needed for the previous
+ *    chunk, was not prefetched early enough: the window is doubled (up to max_window).
+ *  - after shrink_after consecutive reads without a stall, the window is decreased by one (down to min_window), so
+ *    that fast storage or slow consumers do not keep more data in the page cache than necessary.
+ */
+class ReadAhead {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  ReadAhead(const std::string& file_path, size_t chunk_size, size_t max_window, size_t min_window = 1)
+      : _chunk_size(chunk_size),
+        _min_window(std::max<size_t>(1, min_window)),
+        _max_window(std::max(_min_window, max_window)),
+        _window(_min_window),
+        _fd(::open(file_path.c_str(), O_RDONLY)) {
+    if (_fd != -1) {
+      ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+  }
+
+  ~ReadAhead() {
+    if (_fd != -1) {
+      ::close(_fd);
+    }
+  }
+
+  /// not copyable
+  ReadAhead(const ReadAhead&) = delete;
+  ReadAhead& operator=(const ReadAhead&) = delete;
+
+  /// movable
+  ReadAhead(ReadAhead&& other) noexcept
+      : _chunk_size(other._chunk_size),
+        _min_window(other._min_window),
+        _max_window(other._max_window),
+        _window(other._window),
+        _fd(std::exchange(other._fd, -1)),
+        _prefetched_until(other._prefetched_until),
+        _last_read_end(other._last_read_end),
+        _num_fast_reads(other._num_fast_reads) {}
+  ReadAhead& operator=(ReadAhead&&) = delete;
+
+  /**
+   * Call right before reading size bytes at offset: prefetches the window following this read.
+   */
+  void before_read(uint64_t offset, size_t size) {
+    _read_begin = clock::now();
+    prefetch(offset + size);
+  }
+
+  /**
+   * Call right after the read announced using before_read() finished: adapts the window.
+   */
+  void after_read() {
+    auto now = clock::now();
+    auto read_time = now - _read_begin;
+    if (_last_read_end != clock::time_point()) {
+      // time the consumers spent on the previous chunk
+      auto consume_time = _read_begin - _last_read_end;
+      if (read_time > consume_time * stall_ratio) {
+        _window = std::min(_max_window, _window * 2);
+        _num_fast_reads = 0;
+      } else if (++_num_fast_reads >= shrink_after) {
+        _window = std::max(_min_window, _window - 1);
+        _num_fast_reads = 0;
+      }
+    }
+    _last_read_end = now;
+  }
+
+  /// the chunk size changed (c.f. ChunkSizeTuner): the window is kept in chunks
+  void set_chunk_size(size_t chunk_size) { _chunk_size = chunk_size; }
+
+  /// current window size in chunks
+  [[nodiscard]] size_t window() const { return _window; }
+
+  static constexpr double stall_ratio = 0.25;
+  static constexpr size_t shrink_after = 16;
+
+ private:
+  void prefetch(uint64_t offset) {
+    if (_fd == -1) {
+      return;
+    }
+    uint64_t target = offset + _window * _chunk_size;
+    uint64_t begin = std::max(offset, _prefetched_until);
+    if (target > begin) {
+      ::posix_fadvise(_fd, static_cast<off_t>(begin), static_cast<off_t>(target - begin), POSIX_FADV_WILLNEED);
+      _prefetched_until = target;
+    }
+  }
+
+  size_t _chunk_size;
+  size_t _min_window;
+  size_t _max_window;
+  size_t _window;
+  int _fd = -1;
+  uint64_t _prefetched_until = 0;
+  clock::time_point _read_begin;
+  clock::time_point _last_read_end;
+  size_t _num_fast_reads = 0;
+};
+
+}  // namespace xs::utils
@@ -0,0 +1,79 @@
+/**
+ * Copyright 2023, Leon Freist (https://github.com/lfreist)
+ * Author: Leon Freist <freist.leon@gmail.com>
+ *
+ * This file is part of x-search.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace xs::utils {
+
+/**
+ * Bounded multi-producer/multi-consumer FIFO queue on a ring of slots (ticket based, no locks): push() and pop()
+ *  claim a slot using a single atomic increment and then wait (std::atomic::wait, no busy spinning) only until this
+ *  slot was released by the previous lap, so producers and consumers never contend on a common lock.
+ *  push() blocks while the queue is full, pop() blocks while it is empty. There is no close(): consumers are stopped
+ *  by pushing sentinel values (e.g. std::nullopt with T = std::optional<...>).
+ *
+ * @tparam T - element type, default constructible and move assignable
+ */
+template <typename T>
+class RingQueue {
+  static constexpr size_t cache_line_size = 64;
+
+  struct alignas(cache_line_size) Slot {
+    /// 2 * lap: free for the push of lap, 2 * lap + 1: holds the value of lap
+    std::atomic<size_t> turn{0};
+    T value{};
+  };
+
+ public:
+  explicit RingQueue(size_t capacity)
+      : _capacity(capacity < 1 ? 1 : capacity), _slots(std::make_unique<Slot[]>(_capacity)) {}
+
+  /// not copyable/movable
+  RingQueue(const RingQueue&) = delete;
+  RingQueue& operator=(const RingQueue&) = delete;
+
+  void push(T&& value) {
+    size_t ticket = _head.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = _slots[ticket % _capacity];
+    wait_for(slot, 2 * (ticket / _capacity));
+    slot.value = std::move(value);
+    slot.turn.store(2 * (ticket / _capacity) + 1, std::memory_order_release);
+    slot.turn.notify_all();
+  }
+
+  T pop() {
+    size_t ticket = _tail.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = _slots[ticket % _capacity];
+    wait_for(slot, 2 * (ticket / _capacity) + 1);
+    T value = std::move(slot.value);
+    slot.turn.store(2 * (ticket / _capacity) + 2, std::memory_order_release);
+    slot.turn.notify_all();
+    return value;
+  }
+
+  [[nodiscard]] size_t capacity() const { return _capacity; }
+
+ private:
+  static void wait_for(Slot& slot, size_t turn) {
+    size_t current;
+    while ((current = slot.turn.load(std::memory_order_acquire)) != turn) {
+      slot.turn.wait(current, std::memory_order_acquire);
+    }
+  }
+
+  size_t _capacity;
+  std::unique_ptr<Slot[]> _slots;
+  alignas(cache_line_size) std::atomic<size_t> _head{0};
+  alignas(cache_line_size) std::atomic<size_t> _tail{0};
+};
+
+}  // namespace xs::utils
@@ -7,7 +7,6 @@
 #include <condition_variable>
 #include <functional>
 #include <mutex>
-#include <future>
 
 namespace xs::utils {
 
@@ -26,25 +25,27 @@ class Semaphore {
   explicit Semaphore(int max_workers)
       : _max_workers(max_workers < 1 ? 1 : max_workers) {}
 
+  /**
+   * Run func on the calling thread once less than max_workers other threads are running a function.
+   */
   template <typename F>
   requires std::invocable<F>
   auto access(F func) {
-    std::unique_lock lock(_mutex);
-    _cv.wait(lock, [&]() { return _current_workers < _max_workers; });
-    _current_workers++;
-    lock.unlock();
-
-    auto task = std::async(std::launch::async, func);
-
-    lock.lock();
-    _current_workers--;
-    _cv.notify_all();
-
-    if constexpr (std::is_void_v<decltype(func())>) {
-      task.get();
-    } else {
-      return task.get();
+    {
+      std::unique_lock lock(_mutex);
+      _cv.wait(lock, [&]() { return _current_workers < _max_workers; });
+      _current_workers++;
     }
+    // releases the slot when func returns or throws
+    struct Release {
+      Semaphore* semaphore;
+      ~Release() {
+        std::unique_lock lock(semaphore->_mutex);
+        semaphore->_current_workers--;
+        semaphore->_cv.notify_one();
+      }
+    } release{this};
+    return func();
   }
 
  private:
@@ -0,0 +1,81 @@
+/**
+ * Copyright 2023, Leon Freist (https://github.com/lfreist)
+ * Author: Leon Freist <freist.leon@gmail.com>
+ *
+ * This file is part of x-search.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xs::utils {
+
+/**
+ * Work-stealing executor shared by any number of xs::Searcher instances (c.f. global()), so that concurrent searches
+ *  share a fixed set of worker threads instead of each starting its own threads.
+ *
+ * Every worker owns a deque of tasks: tasks submitted by a worker are pushed to the back of its own deque and popped
+ *  from there again (LIFO, the data of the previous task is likely still cached). Tasks submitted by other threads are
+ *  distributed round robin over the deques. Idle workers steal from the front of the deques of the other workers, so
+ *  uneven task costs (e.g. chunks with many matches) are balanced.
+ *  Continuations of long running task chains are scheduled using yield() instead: they are queued behind all other
+ *  tasks of the worker, so that the chains sharing a worker take turns.
+ */
+class ThreadPool {
+ public:
+  using task_type = std::function<void()>;
+
+  /// num_workers == 0: one worker per hardware thread
+  explicit ThreadPool(size_t num_workers = 0);
+  /// runs all tasks that were submitted already, then joins the workers
+  ~ThreadPool();
+
+  /// not copyable/movable
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// schedule task to be run by one of the workers
+  void submit(task_type task);
+
+  /// like submit(), but called by a worker the task is run after all tasks already queued on this worker (FIFO)
+  void yield(task_type task);
+
+  [[nodiscard]] size_t num_workers() const { return _workers.size(); }
+
+  /// process-wide pool with one worker per hardware thread, created on first use
+  static ThreadPool& global();
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<task_type> tasks;
+  };
+
+  void push(size_t index, task_type task, bool front);
+  void run_worker(size_t index);
+  /// pop a task of the own deque or steal one from another worker, false if there is none
+  bool take(size_t index, task_type& task);
+
+  std::vector<std::unique_ptr<Worker>> _workers;
+  std::vector<std::thread> _threads;
+  std::atomic<size_t> _next_worker{0};
+
+  /// number of submitted tasks not taken by a worker yet, idle workers sleep while it is 0
+  std::atomic<size_t> _pending{0};
+  /// number of sleeping workers: submitting tasks only takes _sleep_mutex if there is one
+  std::atomic<size_t> _sleepers{0};
+  std::mutex _sleep_mutex;
+  std::condition_variable _sleep_cv;
+  bool _stop = false;
+};
+
+}  // namespace xs::utils
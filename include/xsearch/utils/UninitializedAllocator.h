@@ -1,15 +1,40 @@
-#include <xmemory>
+/**
+ * Copyright 2023, Leon Freist (https://github.com/lfreist)
+ * Author: Leon Freist <freist.leon@gmail.com>
+ *
+ * This file is part of x-search.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace xs {
 
+/**
+ * std::allocator that default initializes instead of value initializing: resizing a std::vector<char, ...> does not
+ *  zero the new elements. Used for chunk buffers that are overwritten by a read right after being resized.
+ */
 template <typename T>
 class uninit_allocator : public std::allocator<T> {
   typedef std::allocator<T> A;
   typedef std::allocator_traits<A> a_t;
 
  public:
+  template <typename U>
+  struct rebind {
+    using other = uninit_allocator<U>;
+  };
+
   using A::A;
 
+  uninit_allocator() = default;
+  template <typename U>
+  uninit_allocator(const uninit_allocator<U>& other) noexcept : A(other) {}
   explicit uninit_allocator(const A& a) : A{a} {}
   explicit uninit_allocator(A&& a) : A{std::move(a)} {}
   uninit_allocator(const uninit_allocator&) = default;
@@ -31,4 +56,25 @@ class uninit_allocator : public std::allocator<T> {
   }
 };
 
-}  // namespace xs
\ No newline at end of file
+/**
+ * uninit_allocator whose allocations are aligned to Alignment bytes (e.g. the sector size required by O_DIRECT reads).
+ */
+template <typename T, size_t Alignment>
+class aligned_uninit_allocator : public uninit_allocator<T> {
+ public:
+  static constexpr size_t alignment = Alignment;
+
+  template <typename U>
+  struct rebind {
+    using other = aligned_uninit_allocator<U, Alignment>;
+  };
+
+  aligned_uninit_allocator() = default;
+  template <typename U>
+  aligned_uninit_allocator(const aligned_uninit_allocator<U, Alignment>&) noexcept {}
+
+  T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment))); }
+  void deallocate(T* ptr, size_t n) { ::operator delete(ptr, n * sizeof(T), std::align_val_t(Alignment)); }
+};
+
+}  // namespace xs
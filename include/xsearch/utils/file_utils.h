@@ -0,0 +1,113 @@
+/**
+ * Copyright 2023, Leon Freist (https://github.com/lfreist)
+ * Author: Leon Freist <freist.leon@gmail.com>
+ *
+ * This file is part of x-search.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace xs::utils {
+
+struct FileInfo {
+  std::string path;
+  uint64_t size = 0;
+};
+
+/**
+ * Collect all regular files named by paths: files are taken as they are, directories are walked recursively.
+ *  Directories are walked by num_threads threads in parallel, each thread taking the next pending directory from a
+ *  shared queue, so that the latency of directory reads (e.g. on network file systems) overlaps.
+ *
+ * Symbolic links to directories are not followed (no cycles), unreadable entries are skipped silently.
+ *
+ * @return files sorted by path
+ */
+inline std::vector<FileInfo> list_files(const std::vector<std::string>& paths, size_t num_threads = 4) {
+  namespace fs = std::filesystem;
+  std::vector<FileInfo> files;
+  std::vector<fs::path> pending_dirs;
+  for (const auto& path : paths) {
+    std::error_code ec;
+    auto status = fs::status(path, ec);
+    if (ec) {
+      continue;
+    }
+    if (fs::is_directory(status)) {
+      pending_dirs.emplace_back(path);
+    } else if (fs::is_regular_file(status)) {
+      files.push_back({path, fs::file_size(path, ec)});
+    }
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  // number of directories that are currently walked: the walk is done once no directory is pending or walked
+  size_t num_busy = 0;
+
+  auto walk = [&]() {
+    std::unique_lock lock(mutex);
+    while (true) {
+      cv.wait(lock, [&]() { return !pending_dirs.empty() || num_busy == 0; });
+      if (pending_dirs.empty()) {
+        return;
+      }
+      fs::path dir = std::move(pending_dirs.back());
+      pending_dirs.pop_back();
+      num_busy++;
+      lock.unlock();
+
+      std::vector<FileInfo> dir_files;
+      std::vector<fs::path> sub_dirs;
+      std::error_code ec;
+      for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        const auto& entry = *it;
+        std::error_code entry_ec;
+        if (entry.is_symlink(entry_ec) && entry.is_directory(entry_ec)) {
+          continue;
+        }
+        if (entry.is_directory(entry_ec)) {
+          sub_dirs.push_back(entry.path());
+        } else if (entry.is_regular_file(entry_ec)) {
+          uint64_t size = entry.file_size(entry_ec);
+          if (!entry_ec) {
+            dir_files.push_back({entry.path().string(), size});
+          }
+        }
+      }
+
+      lock.lock();
+      files.insert(files.end(), std::make_move_iterator(dir_files.begin()), std::make_move_iterator(dir_files.end()));
+      pending_dirs.insert(pending_dirs.end(), std::make_move_iterator(sub_dirs.begin()),
+                          std::make_move_iterator(sub_dirs.end()));
+      num_busy--;
+      cv.notify_all();
+    }
+  };
+
+  if (!pending_dirs.empty()) {
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < std::max<size_t>(1, num_threads); ++i) {
+      threads.emplace_back(walk);
+    }
+    walk();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  std::sort(files.begin(), files.end(), [](const FileInfo& a, const FileInfo& b) { return a.path < b.path; });
+  return files;
+}
+
+}  // namespace xs::utils
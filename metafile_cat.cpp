@@ -38,6 +38,9 @@ int main(int argc, char** argv) {
     std::cout << " Byte offset:\n";
     std::cout << "  original: " << md_val.original_offset << '\n';
     std::cout << "  actual  : " << md_val.actual_offset << '\n';
+    if (compression_type == xs::CompressionType::MIXED) {
+      std::cout << " Compression Type: " << xs::to_string(md_val.compression_type) << '\n';
+    }
     std::cout << " Size (bytes):\n";
     std::cout << "  original: " << md_val.original_size << '\n';
     std::cout << "  actual  : " << md_val.actual_size << '\n';
@@ -0,0 +1,203 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <fcntl.h>
+#include <lz4frame.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <xsearch/FileFormat.h>
+#include <xsearch/GzipIndex.h>
+#include <zstd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace xs {
+
+std::string to_string(FileFormat format) {
+  switch (format) {
+    case FileFormat::GZIP:
+      return "GZIP";
+    case FileFormat::ZSTD:
+      return "ZSTD";
+    case FileFormat::LZ4_FRAME:
+      return "LZ4_FRAME";
+    default:
+      return "PLAIN";
+  }
+}
+
+FileFormat detect_format(const char* data, size_t size) {
+  auto starts_with = [data, size](const char* magic, size_t magic_size) {
+    return size >= magic_size && std::memcmp(data, magic, magic_size) == 0;
+  };
+  if (starts_with("\x1f\x8b\x08", 3)) {
+    return FileFormat::GZIP;
+  }
+  if (starts_with("\x28\xb5\x2f\xfd", 4)) {
+    return FileFormat::ZSTD;
+  }
+  if (starts_with("\x04\x22\x4d\x18", 4)) {
+    return FileFormat::LZ4_FRAME;
+  }
+  return FileFormat::PLAIN;
+}
+
+FileFormat detect_format(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw std::runtime_error("detect_format: cannot open '" + path + "': " + std::strerror(errno));
+  }
+  char magic[4];
+  ssize_t num_bytes = ::pread(fd, magic, sizeof(magic), 0);
+  ::close(fd);
+  if (num_bytes == -1) {
+    throw std::runtime_error("detect_format: cannot read '" + path + "': " + std::strerror(errno));
+  }
+  return detect_format(magic, static_cast<size_t>(num_bytes));
+}
+
+/// read up to size bytes (less only at the end of the file)
+static size_t read_input(int fd, char* dest, size_t size) {
+  size_t total = 0;
+  while (total < size) {
+    ssize_t num_bytes = ::read(fd, dest + total, size - total);
+    if (num_bytes == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(std::string("StreamDecoder: cannot read: ") + std::strerror(errno));
+    }
+    if (num_bytes == 0) {
+      break;
+    }
+    total += static_cast<size_t>(num_bytes);
+  }
+  return total;
+}
+
+// ===== ZSTD ==========================================================================================================
+
+class ZstdStreamDecoder : public StreamDecoder {
+ public:
+  explicit ZstdStreamDecoder(int fd) : _fd(fd), _dctx(ZSTD_createDStream()), _input(ZSTD_DStreamInSize()) {
+    if (_dctx == nullptr) {
+      throw std::runtime_error("ZstdStreamDecoder: cannot create decompression context");
+    }
+    ZSTD_initDStream(_dctx);
+  }
+
+  ~ZstdStreamDecoder() override { ZSTD_freeDStream(_dctx); }
+
+  size_t read(char* dest, size_t size) override {
+    ZSTD_outBuffer out{dest, size, 0};
+    while (out.pos < out.size && !_eof) {
+      if (_in.pos == _in.size) {
+        _in = {_input.data(), read_input(_fd, _input.data(), _input.size()), 0};
+        if (_in.size == 0) {
+          _eof = true;
+          // a return value != 0 of the last call: the frame is not complete
+          if (_hint != 0) {
+            throw std::runtime_error("ZstdStreamDecoder: unexpected end of compressed data");
+          }
+          break;
+        }
+      }
+      _hint = ZSTD_decompressStream(_dctx, &out, &_in);
+      if (ZSTD_isError(_hint)) {
+        throw std::runtime_error(std::string("ZstdStreamDecoder: ") + ZSTD_getErrorName(_hint));
+      }
+    }
+    return out.pos;
+  }
+
+ private:
+  int _fd;
+  ZSTD_DStream* _dctx;
+  std::vector<char> _input;
+  ZSTD_inBuffer _in{nullptr, 0, 0};
+  size_t _hint = 0;
+  bool _eof = false;
+};
+
+// ===== LZ4 frame =====================================================================================================
+
+class LZ4FrameStreamDecoder : public StreamDecoder {
+ public:
+  explicit LZ4FrameStreamDecoder(int fd) : _fd(fd), _input(1 << 16) {
+    if (LZ4F_isError(LZ4F_createDecompressionContext(&_dctx, LZ4F_VERSION))) {
+      throw std::runtime_error("LZ4FrameStreamDecoder: cannot create decompression context");
+    }
+  }
+
+  ~LZ4FrameStreamDecoder() override { LZ4F_freeDecompressionContext(_dctx); }
+
+  size_t read(char* dest, size_t size) override {
+    size_t total = 0;
+    while (total < size && !_eof) {
+      if (_in_pos == _in_size) {
+        _in_size = read_input(_fd, _input.data(), _input.size());
+        _in_pos = 0;
+        if (_in_size == 0) {
+          _eof = true;
+          if (_hint != 0) {
+            throw std::runtime_error("LZ4FrameStreamDecoder: unexpected end of compressed data");
+          }
+          break;
+        }
+      }
+      size_t out_size = size - total;
+      size_t in_size = _in_size - _in_pos;
+      _hint = LZ4F_decompress(_dctx, dest + total, &out_size, _input.data() + _in_pos, &in_size, nullptr);
+      if (LZ4F_isError(_hint)) {
+        throw std::runtime_error(std::string("LZ4FrameStreamDecoder: ") + LZ4F_getErrorName(_hint));
+      }
+      total += out_size;
+      _in_pos += in_size;
+    }
+    return total;
+  }
+
+ private:
+  int _fd;
+  LZ4F_dctx* _dctx = nullptr;
+  std::vector<char> _input;
+  size_t _in_pos = 0;
+  size_t _in_size = 0;
+  size_t _hint = 0;
+  bool _eof = false;
+};
+
+// ===== GZIP ==========================================================================================================
+
+class GzipStreamDecoder : public StreamDecoder {
+ public:
+  explicit GzipStreamDecoder(int fd) : _inflater(fd, file_size(fd), 0) {}
+
+  size_t read(char* dest, size_t size) override { return _inflater.read(dest, size); }
+
+ private:
+  static uint64_t file_size(int fd) {
+    struct stat st {};
+    return ::fstat(fd, &st) == -1 ? 0 : static_cast<uint64_t>(st.st_size);
+  }
+
+  GzipInflater _inflater;
+};
+
+std::unique_ptr<StreamDecoder> StreamDecoder::create(FileFormat format, int fd) {
+  switch (format) {
+    case FileFormat::ZSTD:
+      return std::make_unique<ZstdStreamDecoder>(fd);
+    case FileFormat::LZ4_FRAME:
+      return std::make_unique<LZ4FrameStreamDecoder>(fd);
+    case FileFormat::GZIP:
+      return std::make_unique<GzipStreamDecoder>(fd);
+    default:
+      throw std::runtime_error("StreamDecoder: " + to_string(format) + " data is not compressed");
+  }
+}
+
+}  // namespace xs
@@ -0,0 +1,248 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <unistd.h>
+#include <xsearch/GzipIndex.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace xs {
+
+static constexpr char index_magic[] = "XSGZI001";
+static constexpr size_t window_size = 32768;
+static constexpr size_t input_buffer_size = 1 << 18;
+
+// ===== GzipIndex =====================================================================================================
+
+GzipIndex::GzipIndex(uint64_t compressed_size, uint64_t uncompressed_size, uint64_t span, std::vector<Point> points)
+    : _compressed_size(compressed_size),
+      _uncompressed_size(uncompressed_size),
+      _span(span),
+      _points(std::move(points)) {}
+
+template <typename V>
+static bool read_value(std::ifstream& in, V& value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+template <typename V>
+static void write_value(std::ofstream& out, V value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+std::optional<GzipIndex> GzipIndex::load(const std::string& index_path, uint64_t compressed_size) {
+  std::ifstream in(index_path, std::ios::binary);
+  if (!in.is_open()) {
+    return {};
+  }
+  char magic[sizeof(index_magic) - 1];
+  if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, index_magic, sizeof(magic)) != 0) {
+    return {};
+  }
+  GzipIndex index;
+  uint64_t num_points = 0;
+  if (!read_value(in, index._compressed_size) || !read_value(in, index._uncompressed_size) ||
+      !read_value(in, index._span) || !read_value(in, num_points) || index._compressed_size != compressed_size) {
+    return {};
+  }
+  for (uint64_t i = 0; i < num_points; ++i) {
+    Point point;
+    uint8_t bits = 0;
+    uint32_t size = 0;
+    if (!read_value(in, point.out) || !read_value(in, point.in) || !read_value(in, bits) || !read_value(in, size) ||
+        bits > 7 || size > window_size) {
+      return {};
+    }
+    point.bits = bits;
+    point.window.resize(size);
+    if (!in.read(point.window.data(), size)) {
+      return {};
+    }
+    index._points.push_back(std::move(point));
+  }
+  return index;
+}
+
+void GzipIndex::save(const std::string& index_path) const {
+  std::ofstream out(index_path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    throw std::runtime_error("GzipIndex: cannot open '" + index_path + "' for writing");
+  }
+  out.write(index_magic, sizeof(index_magic) - 1);
+  write_value(out, _compressed_size);
+  write_value(out, _uncompressed_size);
+  write_value(out, _span);
+  write_value(out, static_cast<uint64_t>(_points.size()));
+  for (const auto& point : _points) {
+    write_value(out, point.out);
+    write_value(out, point.in);
+    write_value(out, static_cast<uint8_t>(point.bits));
+    write_value(out, static_cast<uint32_t>(point.window.size()));
+    out.write(point.window.data(), static_cast<std::streamsize>(point.window.size()));
+  }
+  if (!out) {
+    throw std::runtime_error("GzipIndex: cannot write '" + index_path + "'");
+  }
+}
+
+// ===== GzipInflater ==================================================================================================
+
+struct GzipInflater::Stream {
+  z_stream strm{};
+  std::vector<unsigned char> input = std::vector<unsigned char>(input_buffer_size);
+};
+
+static void check_init(int ret) {
+  if (ret != Z_OK) {
+    throw std::runtime_error("GzipInflater: cannot initialize zlib");
+  }
+}
+
+GzipInflater::GzipInflater(int fd, uint64_t compressed_size, uint64_t span)
+    : _stream(std::make_unique<Stream>()),
+      _fd(fd),
+      _compressed_size(compressed_size),
+      _span(span),
+      _window(window_size) {
+  // 15 + 32: gzip or zlib header (auto detected)
+  check_init(inflateInit2(&_stream->strm, 47));
+}
+
+GzipInflater::GzipInflater(int fd, uint64_t compressed_size, const GzipIndex::Point& point)
+    : _stream(std::make_unique<Stream>()),
+      _fd(fd),
+      _compressed_size(compressed_size),
+      _total_out(point.out),
+      _raw(true) {
+  check_init(inflateInit2(&_stream->strm, -15));
+  _in_offset = point.in;
+  if (point.bits > 0) {
+    unsigned char byte = 0;
+    if (::pread(_fd, &byte, 1, static_cast<off_t>(point.in - 1)) != 1) {
+      throw std::runtime_error("GzipInflater: cannot read checkpoint");
+    }
+    inflatePrime(&_stream->strm, point.bits, byte >> (8 - point.bits));
+  }
+  inflateSetDictionary(&_stream->strm, reinterpret_cast<const Bytef*>(point.window.data()),
+                       static_cast<uInt>(point.window.size()));
+}
+
+GzipInflater::~GzipInflater() { inflateEnd(&_stream->strm); }
+
+bool GzipInflater::fill_input() {
+  auto& strm = _stream->strm;
+  while (true) {
+    ssize_t num_bytes = ::pread(_fd, _stream->input.data(), _stream->input.size(), static_cast<off_t>(_in_offset));
+    if (num_bytes == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(std::string("GzipInflater: cannot read: ") + std::strerror(errno));
+    }
+    _in_offset += static_cast<uint64_t>(num_bytes);
+    strm.next_in = _stream->input.data();
+    strm.avail_in = static_cast<uInt>(num_bytes);
+    return num_bytes > 0;
+  }
+}
+
+void GzipInflater::next_member() {
+  auto& strm = _stream->strm;
+  if (_raw) {
+    // a raw stream stops in front of the gzip trailer (crc32 and size, 8 bytes)
+    for (size_t skip = 8; skip > 0;) {
+      if (strm.avail_in == 0 && !fill_input()) {
+        _done = true;
+        return;
+      }
+      size_t n = std::min<size_t>(skip, strm.avail_in);
+      strm.next_in += n;
+      strm.avail_in -= static_cast<uInt>(n);
+      skip -= n;
+    }
+    inflateReset2(&strm, 47);
+    _raw = false;
+  }
+  if (strm.avail_in == 0 && !fill_input()) {
+    _done = true;
+    return;
+  }
+  // anything but another gzip member (e.g. zero padding) ends the data
+  if (strm.next_in[0] != 0x1f) {
+    _done = true;
+    return;
+  }
+  inflateReset(&strm);
+}
+
+size_t GzipInflater::read(char* dest, size_t size) {
+  auto& strm = _stream->strm;
+  strm.next_out = reinterpret_cast<Bytef*>(dest);
+  strm.avail_out = static_cast<uInt>(std::min<size_t>(size, UINT32_MAX));
+  size_t total = 0;
+  while (!_done && total < size) {
+    if (strm.avail_out == 0) {
+      strm.avail_out = static_cast<uInt>(std::min<size_t>(size - total, UINT32_MAX));
+    }
+    if (strm.avail_in == 0 && !fill_input()) {
+      throw std::runtime_error("GzipInflater: unexpected end of compressed data");
+    }
+    Bytef* out_begin = strm.next_out;
+    int ret = inflate(&strm, _span > 0 ? Z_BLOCK : Z_NO_FLUSH);
+    if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+      throw std::runtime_error(std::string("GzipInflater: invalid compressed data: ") +
+                               (strm.msg != nullptr ? strm.msg : "unknown error"));
+    }
+    size_t produced = strm.next_out - out_begin;
+    total += produced;
+    _total_out += produced;
+    if (_span > 0) {
+      update_window(reinterpret_cast<const char*>(out_begin), produced);
+      // end of a deflate block header that is not the last block: a checkpoint can be placed here
+      if ((strm.data_type & 128) && !(strm.data_type & 64) &&
+          (_points.empty() || _total_out - _points.back().out >= _span)) {
+        add_point();
+      }
+    }
+    if (ret == Z_STREAM_END) {
+      next_member();
+    }
+  }
+  return total;
+}
+
+void GzipInflater::update_window(const char* data, size_t size) {
+  if (size >= window_size) {
+    std::memcpy(_window.data(), data + size - window_size, window_size);
+    _window_pos = 0;
+    return;
+  }
+  size_t n = std::min(size, window_size - _window_pos);
+  std::memcpy(_window.data() + _window_pos, data, n);
+  std::memcpy(_window.data(), data + n, size - n);
+  _window_pos = (_window_pos + size) % window_size;
+}
+
+void GzipInflater::add_point() {
+  GzipIndex::Point point;
+  point.out = _total_out;
+  point.in = _in_offset - _stream->strm.avail_in;
+  point.bits = _stream->strm.data_type & 7;
+  if (_total_out < window_size) {
+    point.window.assign(_window.data(), _total_out);
+  } else {
+    point.window.assign(_window.data() + _window_pos, window_size - _window_pos);
+    point.window.append(_window.data(), _window_pos);
+  }
+  _points.push_back(std::move(point));
+}
+
+GzipIndex GzipInflater::index() const { return {_compressed_size, _total_out, _span, _points}; }
+
+}  // namespace xs
@@ -0,0 +1,206 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <xsearch/MetaFile.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace xs {
+
+static uint64_t read_u64(const char* data) {
+  uint64_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static void write_u64(std::ofstream& out, uint64_t value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+std::string to_string(CompressionType compression_type) {
+  switch (compression_type) {
+    case CompressionType::NONE:
+      return "NONE";
+    case CompressionType::ZSTD:
+      return "ZSTD";
+    case CompressionType::LZ4:
+      return "LZ4";
+    case CompressionType::MIXED:
+      return "MIXED";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+MetaFile::MetaFile(std::string file_path, std::ios::openmode mode, CompressionType compression_type,
+                   std::string_view dictionary)
+    : _file_path(std::move(file_path)), _compression_type(compression_type) {
+  if (mode & std::ios::out) {
+    _out.open(_file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!_out.is_open()) {
+      throw std::runtime_error("MetaFile: cannot open '" + _file_path + "' for writing");
+    }
+    auto type = static_cast<int32_t>(_compression_type);
+    if (!dictionary.empty()) {
+      type |= dictionary_flag;
+    }
+    _out.write(reinterpret_cast<const char*>(&type), sizeof(type));
+    if (!dictionary.empty()) {
+      write_u64(_out, dictionary.size());
+      _out.write(dictionary.data(), static_cast<std::streamsize>(dictionary.size()));
+    }
+    return;
+  }
+  _fd = ::open(_file_path.c_str(), O_RDONLY);
+  if (_fd == -1) {
+    throw std::runtime_error("MetaFile: cannot open '" + _file_path + "': " + std::strerror(errno));
+  }
+  struct stat st {};
+  if (::fstat(_fd, &st) == -1) {
+    ::close(_fd);
+    throw std::runtime_error("MetaFile: cannot stat '" + _file_path + "': " + std::strerror(errno));
+  }
+  _size = static_cast<size_t>(st.st_size);
+  if (_size > 0) {
+    void* data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+    if (data == MAP_FAILED) {
+      ::close(_fd);
+      throw std::runtime_error("MetaFile: cannot map '" + _file_path + "': " + std::strerror(errno));
+    }
+    _data = static_cast<const char*>(data);
+  }
+  try {
+    index();
+  } catch (...) {
+    if (_data != nullptr) {
+      ::munmap(const_cast<char*>(_data), _size);
+    }
+    ::close(_fd);
+    throw;
+  }
+}
+
+MetaFile::~MetaFile() {
+  if (_data != nullptr) {
+    ::munmap(const_cast<char*>(_data), _size);
+  }
+  if (_fd != -1) {
+    ::close(_fd);
+  }
+}
+
+CompressionType MetaFile::get_compression_type() const { return _compression_type; }
+
+std::string_view MetaFile::dictionary() const { return _dictionary; }
+
+std::optional<ChunkMetaData> MetaFile::next_chunk_meta_data() {
+  auto index = next_chunk_index();
+  if (!index) {
+    return {};
+  }
+  return chunk_meta_data(index.value());
+}
+
+std::optional<size_t> MetaFile::next_chunk_index() {
+  size_t index = _next_chunk_index.fetch_add(1);
+  if (index >= _chunk_positions.size()) {
+    // keep the cursor from overflowing when called repeatedly after the last chunk
+    _next_chunk_index.store(_chunk_positions.size());
+    return {};
+  }
+  return index;
+}
+
+std::optional<ChunkMetaData> MetaFile::chunk_meta_data(size_t index) const {
+  if (index >= _chunk_positions.size()) {
+    return {};
+  }
+  const char* record = _data + _chunk_positions[index];
+  ChunkMetaData cmd;
+  cmd.original_offset = read_u64(record);
+  cmd.actual_offset = read_u64(record + 8);
+  cmd.original_size = read_u64(record + 16);
+  cmd.actual_size = read_u64(record + 24);
+  uint64_t num_mappings = read_u64(record + 32);
+  if (_compression_type == CompressionType::MIXED) {
+    cmd.compression_type = static_cast<CompressionType>(read_u64(record + 40));
+  }
+  cmd.line_mapping_data.resize(num_mappings);
+  const char* mapping = record + chunk_header_size();
+  for (auto& info : cmd.line_mapping_data) {
+    info.globalByteOffset = read_u64(mapping);
+    info.globalLineIndex = read_u64(mapping + 8);
+    mapping += 16;
+  }
+  return cmd;
+}
+
+size_t MetaFile::num_chunks() const { return _chunk_positions.size(); }
+
+void MetaFile::write(const ChunkMetaData& chunk_meta_data) {
+  if (!_out.is_open()) {
+    throw std::runtime_error("MetaFile: '" + _file_path + "' is not opened for writing");
+  }
+  auto type = chunk_meta_data.compression_type;
+  if (_compression_type == CompressionType::MIXED && type != CompressionType::NONE && type != CompressionType::LZ4 &&
+      type != CompressionType::ZSTD) {
+    throw std::runtime_error("MetaFile: invalid compression type of a chunk (" + to_string(type) + ")");
+  }
+  write_u64(_out, chunk_meta_data.original_offset);
+  write_u64(_out, chunk_meta_data.actual_offset);
+  write_u64(_out, chunk_meta_data.original_size);
+  write_u64(_out, chunk_meta_data.actual_size);
+  write_u64(_out, chunk_meta_data.line_mapping_data.size());
+  if (_compression_type == CompressionType::MIXED) {
+    write_u64(_out, static_cast<uint64_t>(chunk_meta_data.compression_type));
+  }
+  for (const auto& info : chunk_meta_data.line_mapping_data) {
+    write_u64(_out, info.globalByteOffset);
+    write_u64(_out, info.globalLineIndex);
+  }
+  if (!_out) {
+    throw std::runtime_error("MetaFile: cannot write '" + _file_path + "'");
+  }
+}
+
+void MetaFile::index() {
+  if (_size < sizeof(int32_t)) {
+    throw std::runtime_error("MetaFile: '" + _file_path + "' is not a meta file");
+  }
+  int32_t type;
+  std::memcpy(&type, _data, sizeof(type));
+  _compression_type = static_cast<CompressionType>(type & ~dictionary_flag);
+  size_t position = sizeof(int32_t);
+  if (type & dictionary_flag) {
+    if (_size - position < sizeof(uint64_t) || read_u64(_data + position) > _size - position - sizeof(uint64_t)) {
+      throw std::runtime_error("MetaFile: '" + _file_path + "' is truncated");
+    }
+    _dictionary = std::string_view(_data + position + sizeof(uint64_t), read_u64(_data + position));
+    position += sizeof(uint64_t) + _dictionary.size();
+  }
+  const size_t header_size = chunk_header_size();
+  while (position < _size) {
+    if (_size - position < header_size) {
+      throw std::runtime_error("MetaFile: '" + _file_path + "' is truncated");
+    }
+    uint64_t num_mappings = read_u64(_data + position + 32);
+    if (num_mappings > (_size - position - header_size) / 16) {
+      throw std::runtime_error("MetaFile: '" + _file_path + "' is truncated");
+    }
+    _chunk_positions.push_back(position);
+    position += header_size + num_mappings * 16;
+  }
+}
+
+size_t MetaFile::chunk_header_size() const {
+  return (_compression_type == CompressionType::MIXED ? 6 : 5) * sizeof(uint64_t);
+}
+
+}  // namespace xs
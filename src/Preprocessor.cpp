@@ -0,0 +1,410 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <lz4.h>
+#include <lz4hc.h>
+#include <unistd.h>
+#include <xsearch/Preprocessor.h>
+#include <xsearch/tasks/readers.h>
+#include <zdict.h>
+#include <zstd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace xs {
+
+CompressionType compression_type(PreprocessOptions::Algorithm algorithm) {
+  switch (algorithm) {
+    case PreprocessOptions::Algorithm::NONE:
+      return CompressionType::NONE;
+    case PreprocessOptions::Algorithm::LZ4:
+    case PreprocessOptions::Algorithm::LZ4_HC:
+      return CompressionType::LZ4;
+    case PreprocessOptions::Algorithm::ZSTD:
+      return CompressionType::ZSTD;
+    case PreprocessOptions::Algorithm::ADAPTIVE:
+      return CompressionType::MIXED;
+  }
+  return CompressionType::UNKNOWN;
+}
+
+std::string file_extension(PreprocessOptions::Algorithm algorithm) {
+  switch (algorithm) {
+    case PreprocessOptions::Algorithm::NONE:
+      return ".xs";
+    case PreprocessOptions::Algorithm::LZ4:
+      return ".xslz4";
+    case PreprocessOptions::Algorithm::LZ4_HC:
+      return ".xslz4hc";
+    case PreprocessOptions::Algorithm::ZSTD:
+      return ".xszst";
+    case PreprocessOptions::Algorithm::ADAPTIVE:
+      return ".xsmix";
+  }
+  return "";
+}
+
+namespace {
+
+struct Chunk {
+  uint64_t index = 0;
+  uint64_t original_offset = 0;
+  strtype data;
+};
+
+struct ZstdCCtxDeleter {
+  void operator()(ZSTD_CCtx* cctx) const { ZSTD_freeCCtx(cctx); }
+};
+
+struct ZstdCDictDeleter {
+  void operator()(ZSTD_CDict* cdict) const { ZSTD_freeCDict(cdict); }
+};
+
+/// size of the samples the first chunks are split into for dictionary training
+static constexpr size_t dictionary_sample_size = 4096;
+
+/**
+ * Train a ZSTD dictionary of at most dictionary_size bytes on chunks.
+ *
+ * @return the dictionary, empty if training failed (e.g. too little input)
+ */
+std::string train_dictionary(const std::deque<Chunk>& chunks, size_t dictionary_size) {
+  std::string samples;
+  std::vector<size_t> sample_sizes;
+  for (const auto& chunk : chunks) {
+    samples.append(chunk.data.data(), chunk.data.size());
+    for (size_t pos = 0; pos < chunk.data.size(); pos += dictionary_sample_size) {
+      sample_sizes.push_back(std::min(dictionary_sample_size, chunk.data.size() - pos));
+    }
+  }
+  std::string dictionary(dictionary_size, '\0');
+  size_t size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), samples.data(), sample_sizes.data(),
+                                      static_cast<unsigned>(sample_sizes.size()));
+  if (ZDICT_isError(size)) {
+    return {};
+  }
+  dictionary.resize(size);
+  return dictionary;
+}
+
+/**
+ * Line mapping points of a newline aligned chunk starting at original_offset. Line indices are relative to the first
+ *  line of the chunk.
+ *
+ * @return number of new line chars within the chunk
+ */
+uint64_t map_lines(const strtype& data, uint64_t original_offset, size_t mapping_distance,
+                   std::vector<ByteToNewLineMappingInfo>& mapping) {
+  mapping.clear();
+  mapping_distance = std::max<size_t>(1, mapping_distance);
+  const char* begin = data.data();
+  const char* end = data.data() + data.size();
+  const char* last_point = begin;
+  uint64_t line_index = 0;
+  mapping.push_back({original_offset, 0});
+  while (static_cast<size_t>(end - last_point) > mapping_distance) {
+    // first line starting at least mapping_distance bytes after the previous point
+    const char* new_line = search::simd::strchr(last_point + mapping_distance - 1,
+                                                end - (last_point + mapping_distance - 1), '\n');
+    if (new_line == nullptr || new_line + 1 == end) {
+      break;
+    }
+    line_index += std::count(last_point, new_line + 1, '\n');
+    last_point = new_line + 1;
+    mapping.push_back({original_offset + (last_point - begin), line_index});
+  }
+  return line_index + std::count(last_point, end, '\n');
+}
+
+/// true if chunks are compressed using ZSTD (possibly, for ADAPTIVE)
+bool uses_zstd(const PreprocessOptions& options) {
+  return options.algorithm == PreprocessOptions::Algorithm::ZSTD ||
+         options.algorithm == PreprocessOptions::Algorithm::ADAPTIVE;
+}
+
+void compress_lz4(const strtype& data, strtype& dest, bool high_compression, int level) {
+  if (data.size() > LZ4_MAX_INPUT_SIZE) {
+    throw std::runtime_error("preprocess: chunk exceeds the LZ4 block size limit");
+  }
+  int size = static_cast<int>(data.size());
+  dest.resize(LZ4_compressBound(size));
+  int num_bytes = high_compression
+                      ? LZ4_compress_HC(data.data(), dest.data(), size, static_cast<int>(dest.size()), level)
+                      : LZ4_compress_default(data.data(), dest.data(), size, static_cast<int>(dest.size()));
+  if (num_bytes <= 0 && size > 0) {
+    throw std::runtime_error("preprocess: LZ4 compression failed");
+  }
+  dest.resize(num_bytes);
+}
+
+void compress_zstd(ZSTD_CCtx* cctx, const ZSTD_CDict* cdict, const strtype& data, strtype& dest, int level) {
+  dest.resize(ZSTD_compressBound(data.size()));
+  size_t num_bytes = cdict == nullptr
+                         ? ZSTD_compressCCtx(cctx, dest.data(), dest.size(), data.data(), data.size(), level)
+                         : ZSTD_compress_usingCDict(cctx, dest.data(), dest.size(), data.data(), data.size(), cdict);
+  if (ZSTD_isError(num_bytes)) {
+    throw std::runtime_error(std::string("preprocess: ZSTD compression failed: ") + ZSTD_getErrorName(num_bytes));
+  }
+  dest.resize(num_bytes);
+}
+
+/**
+ * Compress data into dest (resized to the compressed size), using cdict if it is not nullptr (ZSTD only). scratch is
+ *  used by ADAPTIVE to hold the second candidate.
+ *
+ * @return the compression type of the chunk
+ */
+CompressionType compress(const PreprocessOptions& options, ZSTD_CCtx* cctx, const ZSTD_CDict* cdict,
+                         const strtype& data, strtype& dest, strtype& scratch) {
+  switch (options.algorithm) {
+    case PreprocessOptions::Algorithm::NONE:
+      dest.assign(data.begin(), data.end());
+      return CompressionType::NONE;
+    case PreprocessOptions::Algorithm::LZ4:
+    case PreprocessOptions::Algorithm::LZ4_HC:
+      compress_lz4(data, dest, options.algorithm == PreprocessOptions::Algorithm::LZ4_HC, options.level);
+      return CompressionType::LZ4;
+    case PreprocessOptions::Algorithm::ZSTD:
+      compress_zstd(cctx, cdict, data, dest, options.level);
+      return CompressionType::ZSTD;
+    case PreprocessOptions::Algorithm::ADAPTIVE: {
+      auto size = static_cast<double>(data.size());
+      double lz4_cost = std::numeric_limits<double>::infinity();
+      if (data.size() <= LZ4_MAX_INPUT_SIZE) {
+        compress_lz4(data, scratch, false, 0);
+        lz4_cost = static_cast<double>(scratch.size()) + options.lz4_decode_cost * size;
+      }
+      compress_zstd(cctx, cdict, data, dest, options.level);
+      double zstd_cost = static_cast<double>(dest.size()) + options.zstd_decode_cost * size;
+      if (zstd_cost < lz4_cost && zstd_cost < size) {
+        return CompressionType::ZSTD;
+      }
+      if (lz4_cost < size) {
+        std::swap(dest, scratch);
+        return CompressionType::LZ4;
+      }
+      dest.assign(data.begin(), data.end());
+      return CompressionType::NONE;
+    }
+  }
+  return CompressionType::UNKNOWN;
+}
+
+template <typename ReaderT>
+void run(ReaderT& reader, std::ofstream* out, const std::string& meta_file_path, const PreprocessOptions& options) {
+  size_t num_threads = std::max<size_t>(1, options.num_threads);
+
+  // the dictionary is trained on the first chunks, they are compressed once it is available
+  std::deque<Chunk> first_chunks;
+  std::string dictionary;
+  std::unique_ptr<ZSTD_CDict, ZstdCDictDeleter> cdict;
+  if (uses_zstd(options) && options.dictionary_size > 0) {
+    uint64_t original_offset = 0;
+    while (original_offset < 100 * options.dictionary_size) {
+      auto data = reader();
+      if (!data) {
+        break;
+      }
+      uint64_t size = data->size();
+      first_chunks.push_back({first_chunks.size(), original_offset, std::move(data.value())});
+      original_offset += size;
+    }
+    dictionary = train_dictionary(first_chunks, options.dictionary_size);
+    if (!dictionary.empty()) {
+      cdict.reset(ZSTD_createCDict(dictionary.data(), dictionary.size(), options.level));
+      if (cdict == nullptr) {
+        throw std::runtime_error("preprocess: cannot create ZSTD dictionary");
+      }
+    }
+  }
+  MetaFile meta_file(meta_file_path, std::ios::out, compression_type(options.algorithm), dictionary);
+
+  // chunks read but not yet taken by a compression thread
+  std::mutex queue_mutex;
+  std::condition_variable queue_cv;
+  std::deque<Chunk> queue;
+  bool done_reading = false;
+
+  // chunks are written in input order
+  std::mutex write_mutex;
+  std::condition_variable write_cv;
+  uint64_t next_write_index = 0;
+  uint64_t actual_offset = 0;
+  uint64_t line_index = 0;
+
+  std::exception_ptr error;
+  std::atomic<bool> failed = false;
+  auto fail = [&]() {
+    {
+      std::unique_lock lock(write_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+    failed.store(true);
+    {
+      std::unique_lock lock(queue_mutex);
+      done_reading = true;
+    }
+    queue_cv.notify_all();
+    write_cv.notify_all();
+  };
+
+  auto compress_chunks = [&]() {
+    try {
+      std::unique_ptr<ZSTD_CCtx, ZstdCCtxDeleter> cctx;
+      if (uses_zstd(options)) {
+        cctx.reset(ZSTD_createCCtx());
+        if (cctx == nullptr) {
+          throw std::runtime_error("preprocess: cannot create ZSTD compression context");
+        }
+      }
+      strtype compressed;
+      strtype scratch;
+      std::vector<ByteToNewLineMappingInfo> mapping;
+      while (true) {
+        Chunk chunk;
+        {
+          std::unique_lock lock(queue_mutex);
+          queue_cv.wait(lock, [&]() { return !queue.empty() || done_reading; });
+          if (queue.empty() || failed.load()) {
+            return;
+          }
+          chunk = std::move(queue.front());
+          queue.pop_front();
+        }
+        queue_cv.notify_all();
+
+        uint64_t num_lines = map_lines(chunk.data, chunk.original_offset, options.mapping_distance, mapping);
+        CompressionType chunk_compression_type = CompressionType::NONE;
+        if (out != nullptr) {
+          chunk_compression_type = compress(options, cctx.get(), cdict.get(), chunk.data, compressed, scratch);
+        }
+
+        std::unique_lock lock(write_mutex);
+        write_cv.wait(lock, [&]() { return next_write_index == chunk.index || failed.load(); });
+        if (failed.load()) {
+          return;
+        }
+        ChunkMetaData cmd;
+        cmd.original_offset = chunk.original_offset;
+        cmd.original_size = chunk.data.size();
+        if (out != nullptr) {
+          out->write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+          if (!*out) {
+            throw std::runtime_error("preprocess: cannot write compressed data");
+          }
+          cmd.actual_offset = actual_offset;
+          cmd.actual_size = compressed.size();
+        } else {
+          cmd.actual_offset = chunk.original_offset;
+          cmd.actual_size = chunk.data.size();
+        }
+        for (auto& point : mapping) {
+          point.globalLineIndex += line_index;
+        }
+        cmd.line_mapping_data = std::move(mapping);
+        if (options.algorithm == PreprocessOptions::Algorithm::ADAPTIVE) {
+          cmd.compression_type = chunk_compression_type;
+        }
+        meta_file.write(cmd);
+        mapping = std::move(cmd.line_mapping_data);
+        actual_offset += cmd.actual_size;
+        line_index += num_lines;
+        next_write_index++;
+        lock.unlock();
+        write_cv.notify_all();
+        reader.recycle(std::move(chunk.data));
+      }
+    } catch (...) {
+      fail();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back(compress_chunks);
+  }
+
+  try {
+    uint64_t index = 0;
+    uint64_t original_offset = 0;
+    while (!failed.load()) {
+      std::optional<strtype> data;
+      if (first_chunks.empty()) {
+        data = reader();
+      } else {
+        data = std::move(first_chunks.front().data);
+        first_chunks.pop_front();
+      }
+      if (!data) {
+        break;
+      }
+      uint64_t size = data->size();
+      std::unique_lock lock(queue_mutex);
+      // at most num_threads chunks wait for compression
+      queue_cv.wait(lock, [&]() { return queue.size() < num_threads || done_reading; });
+      if (done_reading) {
+        break;
+      }
+      queue.push_back({index++, original_offset, std::move(data.value())});
+      original_offset += size;
+      lock.unlock();
+      queue_cv.notify_all();
+    }
+  } catch (...) {
+    fail();
+  }
+  {
+    std::unique_lock lock(queue_mutex);
+    done_reading = true;
+  }
+  queue_cv.notify_all();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace
+
+void preprocess(const std::string& input_path, const std::string& output_path, const std::string& meta_file_path,
+                const PreprocessOptions& options) {
+  if (output_path.empty() && (options.algorithm != PreprocessOptions::Algorithm::NONE || input_path == "-")) {
+    throw std::runtime_error("preprocess: no output file given");
+  }
+  std::unique_ptr<std::ofstream> out;
+  if (!output_path.empty()) {
+    out = std::make_unique<std::ofstream>(output_path, std::ios::binary | std::ios::trunc);
+    if (!out->is_open()) {
+      throw std::runtime_error("preprocess: cannot open '" + output_path + "' for writing");
+    }
+  }
+  size_t max_pooled_buffers = 2 * std::max<size_t>(1, options.num_threads) + 1;
+  if (input_path == "-") {
+    StreamReader<strtype> reader(STDIN_FILENO, options.chunk_size, true, max_pooled_buffers);
+    run(reader, out.get(), meta_file_path, options);
+  } else {
+    if (::access(input_path.c_str(), R_OK) != 0) {
+      throw std::runtime_error("preprocess: cannot read '" + input_path + "'");
+    }
+    FileReader<strtype> reader(input_path, options.chunk_size, true, max_pooled_buffers);
+    run(reader, out.get(), meta_file_path, options);
+  }
+}
+
+}  // namespace xs
@@ -0,0 +1,457 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <xsearch/SpeculativeInflater.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace xs {
+
+static constexpr uint16_t placeholder_base = 256;
+
+// ===== bit stream ====================================================================================================
+
+class BitReader {
+ public:
+  BitReader(const uint8_t* data, size_t size, uint64_t position) : _data(data), _size(size), _position(position) {}
+
+  /// the next n (<= 56) bits without consuming them (zeros beyond the end of the data)
+  [[nodiscard]] uint64_t peek(unsigned n) const {
+    size_t byte = _position >> 3;
+    uint64_t value = 0;
+    if (byte + sizeof(value) <= _size) {
+      std::memcpy(&value, _data + byte, sizeof(value));
+    } else if (byte < _size) {
+      std::memcpy(&value, _data + byte, _size - byte);
+    }
+    return (value >> (_position & 7)) & ((uint64_t(1) << n) - 1);
+  }
+
+  void consume(unsigned n) { _position += n; }
+
+  uint64_t bits(unsigned n) {
+    uint64_t value = peek(n);
+    consume(n);
+    return value;
+  }
+
+  void align() { _position = (_position + 7) & ~uint64_t(7); }
+
+  [[nodiscard]] uint64_t position() const { return _position; }
+  void set_position(uint64_t position) { _position = position; }
+
+  /// true if more bits were consumed than available
+  [[nodiscard]] bool overflow() const { return _position > uint64_t(_size) * 8; }
+
+ private:
+  const uint8_t* _data;
+  size_t _size;
+  uint64_t _position;
+};
+
+// ===== Huffman decoding ==============================================================================================
+
+/// canonical Huffman code: codes of up to fast_bits bits are decoded by table lookup, longer ones bit by bit
+class Huffman {
+ public:
+  /// false if the code lengths do not describe a valid code (incomplete codes are accepted for a single code only)
+  bool build(const uint8_t* lengths, unsigned n) {
+    std::fill(std::begin(_count), std::end(_count), 0);
+    for (unsigned symbol = 0; symbol < n; ++symbol) {
+      _count[lengths[symbol]]++;
+    }
+    _count[0] = 0;
+    int left = 1;
+    unsigned max_length = 0;
+    for (unsigned length = 1; length <= max_bits; ++length) {
+      left = (left << 1) - _count[length];
+      if (left < 0) {
+        return false;
+      }
+      if (_count[length] > 0) {
+        max_length = length;
+      }
+    }
+    if (left > 0 && max_length > 1) {
+      return false;
+    }
+    uint16_t offsets[max_bits + 2] = {0};
+    uint16_t next_code[max_bits + 1] = {0};
+    for (unsigned length = 1; length <= max_bits; ++length) {
+      offsets[length + 1] = offsets[length] + _count[length];
+      next_code[length] = (next_code[length - 1] + _count[length - 1]) << 1;
+    }
+    std::fill(std::begin(_table), std::end(_table), 0);
+    for (unsigned symbol = 0; symbol < n; ++symbol) {
+      unsigned length = lengths[symbol];
+      if (length == 0) {
+        continue;
+      }
+      _symbols[offsets[length]++] = symbol;
+      unsigned code = next_code[length]++;
+      if (length > fast_bits) {
+        continue;
+      }
+      // deflate stores codes starting with their most significant bit
+      unsigned reversed = 0;
+      for (unsigned i = 0; i < length; ++i) {
+        reversed |= ((code >> i) & 1) << (length - 1 - i);
+      }
+      for (unsigned entry = reversed; entry < (1u << fast_bits); entry += 1u << length) {
+        _table[entry] = static_cast<uint16_t>(symbol << 4 | length);
+      }
+    }
+    return true;
+  }
+
+  /// the next symbol, -1 for an invalid code
+  int decode(BitReader& reader) const {
+    uint16_t entry = _table[reader.peek(fast_bits)];
+    if (entry != 0) {
+      reader.consume(entry & 15);
+      return entry >> 4;
+    }
+    uint64_t bits = reader.peek(max_bits);
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (unsigned length = 1; length <= max_bits; ++length) {
+      code |= static_cast<int>(bits & 1);
+      bits >>= 1;
+      int count = _count[length];
+      if (code - count < first) {
+        reader.consume(length);
+        return _symbols[index + (code - first)];
+      }
+      index += count;
+      first = (first + count) << 1;
+      code <<= 1;
+    }
+    return -1;
+  }
+
+ private:
+  static constexpr unsigned max_bits = 15;
+  static constexpr unsigned fast_bits = 10;
+
+  uint16_t _count[max_bits + 1];
+  uint16_t _symbols[288];
+  /// symbol << 4 | code length, 0: code is longer than fast_bits
+  uint16_t _table[1 << fast_bits];
+};
+
+static const Huffman& fixed_literal_code() {
+  static const Huffman code = [] {
+    uint8_t lengths[288];
+    std::fill(lengths, lengths + 144, 8);
+    std::fill(lengths + 144, lengths + 256, 9);
+    std::fill(lengths + 256, lengths + 280, 7);
+    std::fill(lengths + 280, lengths + 288, 8);
+    Huffman huffman;
+    huffman.build(lengths, 288);
+    return huffman;
+  }();
+  return code;
+}
+
+static const Huffman& fixed_distance_code() {
+  static const Huffman code = [] {
+    uint8_t lengths[30];
+    std::fill(lengths, lengths + 30, 5);
+    Huffman huffman;
+    huffman.build(lengths, 30);
+    return huffman;
+  }();
+  return code;
+}
+
+// ===== deflate blocks ================================================================================================
+
+/// read the code tables of a dynamic Huffman block (following the block type)
+static bool read_dynamic_codes(BitReader& reader, Huffman& literals, Huffman& distances) {
+  static constexpr uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+  unsigned num_literals = reader.bits(5) + 257;
+  unsigned num_distances = reader.bits(5) + 1;
+  unsigned num_code_lengths = reader.bits(4) + 4;
+  if (num_literals > 286 || num_distances > 30) {
+    return false;
+  }
+  uint8_t code_lengths[19] = {0};
+  for (unsigned i = 0; i < num_code_lengths; ++i) {
+    code_lengths[order[i]] = reader.bits(3);
+  }
+  Huffman code_length_code;
+  if (!code_length_code.build(code_lengths, 19)) {
+    return false;
+  }
+  uint8_t lengths[286 + 30] = {0};
+  for (unsigned index = 0; index < num_literals + num_distances;) {
+    int symbol = code_length_code.decode(reader);
+    if (symbol < 0) {
+      return false;
+    }
+    if (symbol < 16) {
+      lengths[index++] = symbol;
+      continue;
+    }
+    uint8_t length = 0;
+    unsigned repeat;
+    if (symbol == 16) {
+      if (index == 0) {
+        return false;
+      }
+      length = lengths[index - 1];
+      repeat = 3 + reader.bits(2);
+    } else if (symbol == 17) {
+      repeat = 3 + reader.bits(3);
+    } else {
+      repeat = 11 + reader.bits(7);
+    }
+    if (index + repeat > num_literals + num_distances) {
+      return false;
+    }
+    std::fill(lengths + index, lengths + index + repeat, length);
+    index += repeat;
+  }
+  // the end of block code is required
+  return lengths[256] != 0 && literals.build(lengths, num_literals) &&
+         distances.build(lengths + num_literals, num_distances) && !reader.overflow();
+}
+
+/// inflate the data of a Huffman coded block, back-references preceding out are replaced by placeholders
+static bool inflate_codes(BitReader& reader, const Huffman& literals, const Huffman& distances,
+                          std::vector<uint16_t>& out) {
+  static constexpr uint16_t length_base[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                               31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+  static constexpr uint8_t length_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                               2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+  static constexpr uint16_t distance_base[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,
+                                                 33,  49,  65,  97,  129, 193,  257,  385,  513,  769,
+                                                 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+  static constexpr uint8_t distance_extra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                                 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+  while (!reader.overflow()) {
+    int symbol = literals.decode(reader);
+    if (symbol < 0) {
+      return false;
+    }
+    if (symbol < 256) {
+      out.push_back(static_cast<uint16_t>(symbol));
+      continue;
+    }
+    if (symbol == 256) {
+      return true;
+    }
+    symbol -= 257;
+    if (symbol >= 29) {
+      return false;
+    }
+    size_t length = length_base[symbol] + reader.bits(length_extra[symbol]);
+    int distance_symbol = distances.decode(reader);
+    if (distance_symbol < 0 || distance_symbol >= 30) {
+      return false;
+    }
+    size_t distance = distance_base[distance_symbol] + reader.bits(distance_extra[distance_symbol]);
+    size_t position = out.size();
+    if (distance > position + SpeculativeInflater::window_size) {
+      return false;
+    }
+    out.resize(position + length);
+    uint16_t* dest = out.data() + position;
+    for (size_t i = 0; i < length; ++i) {
+      auto source = static_cast<int64_t>(position + i) - static_cast<int64_t>(distance);
+      dest[i] = source >= 0 ? out[source]
+                            : static_cast<uint16_t>(placeholder_base + SpeculativeInflater::window_size + source);
+    }
+  }
+  return false;
+}
+
+/// inflate the block at the position of reader, last is set to the final block flag
+static bool inflate_block(BitReader& reader, const uint8_t* data, size_t size, std::vector<uint16_t>& out,
+                          bool& last) {
+  last = reader.bits(1);
+  switch (reader.bits(2)) {
+    case 0: {
+      reader.align();
+      auto length = static_cast<uint16_t>(reader.bits(16));
+      auto inverted = static_cast<uint16_t>(reader.bits(16));
+      size_t byte = reader.position() / 8;
+      if (length != static_cast<uint16_t>(~inverted) || byte + length > size) {
+        return false;
+      }
+      out.insert(out.end(), data + byte, data + byte + length);
+      reader.set_position((byte + length) * 8);
+      return true;
+    }
+    case 1:
+      return inflate_codes(reader, fixed_literal_code(), fixed_distance_code(), out);
+    case 2: {
+      Huffman literals;
+      Huffman distances;
+      return read_dynamic_codes(reader, literals, distances) && inflate_codes(reader, literals, distances, out);
+    }
+    default:
+      return false;
+  }
+}
+
+/// offset of the deflate data of the gzip member at offset
+static std::optional<size_t> gzip_header_end(const uint8_t* data, size_t size, size_t offset) {
+  if (offset + 10 > size || data[offset] != 0x1f || data[offset + 1] != 0x8b || data[offset + 2] != 8) {
+    return {};
+  }
+  uint8_t flags = data[offset + 3];
+  size_t position = offset + 10;
+  if (flags & 4) {
+    if (position + 2 > size) {
+      return {};
+    }
+    position += 2 + (data[position] | data[position + 1] << 8);
+  }
+  for (uint8_t flag : {8, 16}) {
+    if (flags & flag) {
+      const void* end = position < size ? std::memchr(data + position, 0, size - position) : nullptr;
+      if (end == nullptr) {
+        return {};
+      }
+      position = static_cast<const uint8_t*>(end) - data + 1;
+    }
+  }
+  if (flags & 2) {
+    position += 2;
+  }
+  if (position > size) {
+    return {};
+  }
+  return position;
+}
+
+// ===== SpeculativeInflater ===========================================================================================
+
+SpeculativeInflater::SpeculativeInflater(const char* data, size_t size, size_t chunk_size)
+    : _data(reinterpret_cast<const uint8_t*>(data)),
+      _size(size),
+      _num_chunks(std::max<size_t>(1, size / std::max<size_t>(1, chunk_size))),
+      _located(std::make_unique<std::once_flag[]>(_num_chunks)),
+      _block_starts(_num_chunks) {
+  auto header_end = gzip_header_end(_data, _size, 0);
+  if (!header_end) {
+    throw std::runtime_error("SpeculativeInflater: data is not gzip compressed");
+  }
+  _first_block = *header_end * 8;
+}
+
+std::optional<uint64_t> SpeculativeInflater::block_start(size_t k) const {
+  std::call_once(_located[k], [this, k]() { _block_starts[k] = find_block_start(k); });
+  return _block_starts[k];
+}
+
+std::optional<uint64_t> SpeculativeInflater::find_block_start(size_t k) const {
+  if (k == 0) {
+    return _first_block;
+  }
+  uint64_t begin = std::max<uint64_t>(_first_block, uint64_t(k * (_size / _num_chunks)) * 8);
+  uint64_t end = k + 1 < _num_chunks ? uint64_t((k + 1) * (_size / _num_chunks)) * 8 : uint64_t(_size) * 8;
+  std::vector<uint16_t> out;
+  Huffman literals;
+  Huffman distances;
+  for (uint64_t position = begin; position < end; ++position) {
+    BitReader reader(_data, _size, position);
+    // not the final block, dynamic Huffman codes
+    if (reader.bits(3) != 4 || !read_dynamic_codes(reader, literals, distances)) {
+      continue;
+    }
+    out.clear();
+    if (!inflate_codes(reader, literals, distances, out) || reader.overflow()) {
+      continue;
+    }
+    // the header of the following block must be valid as well
+    reader.consume(1);
+    switch (reader.bits(2)) {
+      case 0: {
+        reader.align();
+        auto length = static_cast<uint16_t>(reader.bits(16));
+        if (length != static_cast<uint16_t>(~reader.bits(16))) {
+          continue;
+        }
+        break;
+      }
+      case 1:
+        break;
+      case 2:
+        if (!read_dynamic_codes(reader, literals, distances)) {
+          continue;
+        }
+        break;
+      default:
+        continue;
+    }
+    if (!reader.overflow()) {
+      return position;
+    }
+  }
+  return {};
+}
+
+SpeculativeInflater::Chunk SpeculativeInflater::inflate(size_t k) const {
+  auto start = block_start(k);
+  if (!start) {
+    throw std::runtime_error("SpeculativeInflater: no deflate block found in chunk " + std::to_string(k));
+  }
+  Chunk chunk;
+  chunk.symbols.reserve(4 * (_size / _num_chunks));
+  BitReader reader(_data, _size, *start);
+  chunk.next_chunk = k + 1;
+  while (true) {
+    // stop at the start of a following chunk
+    for (; chunk.next_chunk < _num_chunks; ++chunk.next_chunk) {
+      auto next_start = block_start(chunk.next_chunk);
+      if (next_start && *next_start >= reader.position()) {
+        break;
+      }
+    }
+    if (chunk.next_chunk < _num_chunks && *block_start(chunk.next_chunk) == reader.position()) {
+      return chunk;
+    }
+    bool last = false;
+    if (!inflate_block(reader, _data, _size, chunk.symbols, last) || reader.overflow()) {
+      throw std::runtime_error("SpeculativeInflater: invalid compressed data");
+    }
+    if (last) {
+      // skip the member trailer (crc32 and size), the data ends with anything but another member
+      reader.align();
+      size_t trailer_end = reader.position() / 8 + 8;
+      if (trailer_end > _size) {
+        throw std::runtime_error("SpeculativeInflater: unexpected end of compressed data");
+      }
+      auto header_end = gzip_header_end(_data, _size, trailer_end);
+      if (!header_end) {
+        chunk.next_chunk = _num_chunks;
+        return chunk;
+      }
+      reader.set_position(*header_end * 8);
+    }
+  }
+}
+
+void SpeculativeInflater::resolve(const uint16_t* symbols, size_t size, std::string_view window, char* dest) {
+  size_t missing = window_size - std::min(window_size, window.size());
+  for (size_t i = 0; i < size; ++i) {
+    uint16_t symbol = symbols[i];
+    if (symbol < placeholder_base) {
+      dest[i] = static_cast<char>(symbol);
+      continue;
+    }
+    size_t index = symbol - placeholder_base;
+    if (index < missing) {
+      throw std::runtime_error("SpeculativeInflater: back-reference before the beginning of the data");
+    }
+    dest[i] = window[window.size() - window_size + index];
+  }
+}
+
+}  // namespace xs
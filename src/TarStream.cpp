@@ -0,0 +1,208 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <xsearch/TarStream.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace xs {
+
+static constexpr size_t block_size = 512;
+
+/// numeric header field: octal (NUL or space terminated) or base-256 (GNU, first byte has its high bit set)
+static uint64_t parse_number(const char* field, size_t size) {
+  const auto* bytes = reinterpret_cast<const unsigned char*>(field);
+  uint64_t value = 0;
+  if (bytes[0] & 0x80) {
+    value = bytes[0] & 0x7f;
+    for (size_t i = 1; i < size; ++i) {
+      value = (value << 8) | bytes[i];
+    }
+    return value;
+  }
+  size_t i = 0;
+  while (i < size && field[i] == ' ') {
+    ++i;
+  }
+  for (; i < size && field[i] >= '0' && field[i] <= '7'; ++i) {
+    value = (value << 3) | static_cast<uint64_t>(field[i] - '0');
+  }
+  return value;
+}
+
+/// NUL terminated header field of at most size chars
+static std::string parse_string(const char* field, size_t size) {
+  return {field, static_cast<size_t>(std::find(field, field + size, '\0') - field)};
+}
+
+/// the checksum is the sum of all header bytes, the checksum field counting as spaces
+static bool valid_checksum(const char* header) {
+  const auto* bytes = reinterpret_cast<const unsigned char*>(header);
+  uint64_t sum = 0;
+  for (size_t i = 0; i < block_size; ++i) {
+    sum += (i >= 148 && i < 156) ? ' ' : bytes[i];
+  }
+  return sum == parse_number(header + 148, 8);
+}
+
+TarStream::TarStream(const std::string& path) {
+  FileFormat format = detect_format(path);
+  _fd = ::open(path.c_str(), O_RDONLY);
+  if (_fd == -1) {
+    throw std::runtime_error("TarStream: cannot open '" + path + "': " + std::strerror(errno));
+  }
+  ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  if (format != FileFormat::PLAIN) {
+    try {
+      _decoder = StreamDecoder::create(format, _fd);
+    } catch (...) {
+      ::close(_fd);
+      throw;
+    }
+  }
+}
+
+TarStream::~TarStream() {
+  _decoder.reset();
+  if (_fd != -1) {
+    ::close(_fd);
+  }
+}
+
+size_t TarStream::read_archive(char* dest, size_t size) {
+  if (_decoder != nullptr) {
+    return _decoder->read(dest, size);
+  }
+  size_t total = 0;
+  while (total < size) {
+    ssize_t num_bytes = ::read(_fd, dest + total, size - total);
+    if (num_bytes == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(std::string("TarStream: cannot read: ") + std::strerror(errno));
+    }
+    if (num_bytes == 0) {
+      break;
+    }
+    total += static_cast<size_t>(num_bytes);
+  }
+  return total;
+}
+
+void TarStream::skip(uint64_t size) {
+  char buffer[1 << 14];
+  while (size > 0) {
+    size_t num_bytes = read_archive(buffer, std::min<uint64_t>(size, sizeof(buffer)));
+    if (num_bytes == 0) {
+      throw std::runtime_error("TarStream: unexpected end of archive");
+    }
+    size -= num_bytes;
+  }
+}
+
+std::string TarStream::read_payload(uint64_t size) {
+  std::string payload(size, '\0');
+  if (read_archive(payload.data(), size) != size) {
+    throw std::runtime_error("TarStream: unexpected end of archive");
+  }
+  skip((block_size - size % block_size) % block_size);
+  return payload;
+}
+
+std::optional<TarStream::Member> TarStream::next_member() {
+  if (_done) {
+    return {};
+  }
+  skip(_remaining + _padding);
+  _remaining = 0;
+  _padding = 0;
+  std::optional<std::string> long_path;
+  // size of the next member given by a PAX header (not a std::optional: GCC reports it maybe-uninitialized)
+  bool has_pax_size = false;
+  uint64_t pax_size = 0;
+  char header[block_size];
+  while (true) {
+    size_t num_bytes = read_archive(header, block_size);
+    if (num_bytes == 0 || std::all_of(header, header + num_bytes, [](char c) { return c == '\0'; })) {
+      // end of archive marker (or archive without it)
+      _done = true;
+      return {};
+    }
+    if (num_bytes < block_size) {
+      throw std::runtime_error("TarStream: unexpected end of archive");
+    }
+    if (!valid_checksum(header)) {
+      throw std::runtime_error("TarStream: invalid header (not a tar archive or corrupted)");
+    }
+    uint64_t size = parse_number(header + 124, 12);
+    char type = header[156];
+    if (type == 'L') {
+      std::string payload = read_payload(size);
+      long_path = parse_string(payload.data(), payload.size());
+      continue;
+    }
+    if (type == 'x') {
+      // records "<length> <key>=<value>\n"
+      std::string payload = read_payload(size);
+      for (size_t pos = 0; pos < payload.size();) {
+        size_t space = payload.find(' ', pos);
+        size_t length = std::strtoull(payload.c_str() + pos, nullptr, 10);
+        if (space == std::string::npos || length == 0 || pos + length > payload.size()) {
+          break;
+        }
+        std::string record = payload.substr(space + 1, pos + length - space - 2);
+        size_t equals = record.find('=');
+        if (record.compare(0, equals, "path") == 0) {
+          long_path = record.substr(equals + 1);
+        } else if (record.compare(0, equals, "size") == 0) {
+          pax_size = std::strtoull(record.c_str() + equals + 1, nullptr, 10);
+          has_pax_size = true;
+        }
+        pos += length;
+      }
+      continue;
+    }
+    if (has_pax_size) {
+      size = pax_size;
+    }
+    if (type != '0' && type != '\0' && type != '7') {
+      // directories, links, global PAX headers, ...
+      skip(size + (block_size - size % block_size) % block_size);
+      long_path.reset();
+      has_pax_size = false;
+      continue;
+    }
+    Member member;
+    if (long_path) {
+      member.path = std::move(long_path.value());
+    } else {
+      member.path = parse_string(header, 100);
+      std::string prefix = parse_string(header + 345, 155);
+      if (std::memcmp(header + 257, "ustar", 5) == 0 && !prefix.empty()) {
+        member.path = prefix + "/" + member.path;
+      }
+    }
+    member.size = size;
+    _remaining = size;
+    _padding = (block_size - size % block_size) % block_size;
+    return member;
+  }
+}
+
+size_t TarStream::read(char* dest, size_t size) {
+  size_t num_bytes = read_archive(dest, std::min<uint64_t>(size, _remaining));
+  if (num_bytes < std::min<uint64_t>(size, _remaining)) {
+    throw std::runtime_error("TarStream: unexpected end of archive");
+  }
+  _remaining -= num_bytes;
+  return num_bytes;
+}
+
+}  // namespace xs
@@ -54,6 +54,18 @@ inline int count_trailing_zeroes(unsigned int n) {
 #endif
 }
 
+inline int count_leading_zeroes(unsigned int n) {
+#ifdef _MSC_VER
+  int bits = 0;
+  for (unsigned int mask = 0x80000000; mask != 0 && (n & mask) == 0; mask >>= 1) {
+    bits++;
+  }
+  return bits;
+#else
+  return __builtin_clz(n);
+#endif
+}
+
 /// simple strstr implementation for char* that is not null terminated
 const char* scalar_strstr(const char* str, size_t str_len, const char* pattern, size_t pat_len) {
   size_t shift = 0;
@@ -143,6 +155,43 @@ const char* strchr(const char* str, size_t str_len, char c) {
   return scalar_strchr(str, str_len, c);
 }
 
+/// simple implementation of strrchr for char* that is not null terminated
+const char* scalar_strrchr(const char* str, size_t str_len, int c) {
+  while (str_len > 0) {
+    str_len--;
+    if (str[str_len] == c) {
+      return str + str_len;
+    }
+  }
+  return nullptr;
+}
+
+const char* strrchr(const char* str, size_t str_len, char c) {
+  if (str_len < 32) {
+    return scalar_strrchr(str, str_len, c);
+  }
+  // load c into SIMD vector
+  const __m256i _c = _mm256_set1_epi8(c);
+
+  // walk backwards through str in blocks of 32 bytes. If the remaining (leading) str is smaller than 32, we stop and
+  //  perform scalar_strrchr on it
+  while (str_len >= 32) {
+    // load last 32 bytes of the remaining str
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + str_len - 32));
+
+    const __m256i eq = _mm256_cmpeq_epi8(_c, block);
+
+    // create mask
+    uint32_t mask = _mm256_movemask_epi8(eq);
+    if (mask != 0) {
+      const unsigned bitpos = 31 - count_leading_zeroes(mask);  // get index of last true value
+      return str + str_len - 32 + bitpos;                       // return position of match
+    }
+    str_len -= 32;
+  }
+  return scalar_strrchr(str, str_len, c);
+}
+
 /// helper function for strstr
 uint32_t get_mask(const __m256i first, const __m256i last, const __m256i block_first, const __m256i block_last) {
   const __m256i eq_first = _mm256_cmpeq_epi8(first, block_first);
@@ -302,7 +351,12 @@ int64_t findNextNewLine(const char* str, size_t str_len, size_t shift) {
   return match == nullptr ? -1 : match - str;
 }
 
-uint64_t countMatchingLines(const char* pattern, size_t pattern_len, const char* str, size_t str_len) {
+int64_t findLastNewLine(const char* str, size_t str_len) {
+  const char* match = strrchr(str, str_len, '\n');
+  return match == nullptr ? -1 : match - str;
+}
+
+uint64_t findAllPerLine(const char* pattern, size_t pattern_len, const char* str, size_t str_len) {
   uint64_t count = 0;
   size_t shift = 0;
   while (true) {
@@ -321,7 +375,7 @@ uint64_t countMatchingLines(const char* pattern, size_t pattern_len, const char*
   return count;
 }
 
-uint64_t countMatches(const char* pattern, size_t pattern_len, const char* str, size_t str_len) {
+uint64_t findAll(const char* pattern, size_t pattern_len, const char* str, size_t str_len) {
   uint64_t count = 0;
   size_t shift = 0;
   while (true) {
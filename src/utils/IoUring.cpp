@@ -0,0 +1,161 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <xsearch/utils/IoUring.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+namespace xs::utils {
+
+static int io_uring_setup(unsigned entries, io_uring_params* params) {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int io_uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+static int io_uring_register(int ring_fd, unsigned opcode, void* arg, unsigned nr_args) {
+  return static_cast<int>(::syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+/// IORING_OP_READ is available since Linux 5.6, which also introduced IORING_REGISTER_PROBE
+static bool supports_read(int ring_fd) {
+  constexpr unsigned num_ops = 256;
+  alignas(io_uring_probe) char buffer[sizeof(io_uring_probe) + num_ops * sizeof(io_uring_probe_op)]{};
+  auto* probe = reinterpret_cast<io_uring_probe*>(buffer);
+  if (io_uring_register(ring_fd, IORING_REGISTER_PROBE, probe, num_ops) < 0) {
+    return false;
+  }
+  return probe->last_op >= IORING_OP_READ && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) != 0;
+}
+
+static char* offset_ptr(void* base, uint32_t offset) { return static_cast<char*>(base) + offset; }
+
+IoUring::IoUring(unsigned entries) {
+  io_uring_params params{};
+  _ring_fd = io_uring_setup(entries, &params);
+  if (_ring_fd < 0) {
+    throw std::system_error(errno, std::system_category(), "io_uring_setup");
+  }
+  if (!supports_read(_ring_fd)) {
+    ::close(_ring_fd);
+    throw std::system_error(ENOSYS, std::system_category(), "io_uring: IORING_OP_READ not supported");
+  }
+  _sq_entries = params.sq_entries;
+
+  _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+  }
+  _sq_ring = ::mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+                    IORING_OFF_SQ_RING);
+  if (_sq_ring == MAP_FAILED) {
+    int err = errno;
+    ::close(_ring_fd);
+    throw std::system_error(err, std::system_category(), "io_uring: mapping the submission ring");
+  }
+  if (single_mmap) {
+    _cq_ring = _sq_ring;
+  } else {
+    _cq_ring = ::mmap(nullptr, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+                      IORING_OFF_CQ_RING);
+    if (_cq_ring == MAP_FAILED) {
+      int err = errno;
+      ::munmap(_sq_ring, _sq_ring_size);
+      ::close(_ring_fd);
+      throw std::system_error(err, std::system_category(), "io_uring: mapping the completion ring");
+    }
+  }
+  _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+  _sqes = ::mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQES);
+  if (_sqes == MAP_FAILED) {
+    int err = errno;
+    if (_cq_ring != _sq_ring) {
+      ::munmap(_cq_ring, _cq_ring_size);
+    }
+    ::munmap(_sq_ring, _sq_ring_size);
+    ::close(_ring_fd);
+    throw std::system_error(err, std::system_category(), "io_uring: mapping the submission queue entries");
+  }
+
+  _sq_head = reinterpret_cast<unsigned*>(offset_ptr(_sq_ring, params.sq_off.head));
+  _sq_tail = reinterpret_cast<unsigned*>(offset_ptr(_sq_ring, params.sq_off.tail));
+  _sq_mask = reinterpret_cast<unsigned*>(offset_ptr(_sq_ring, params.sq_off.ring_mask));
+  _sq_array = reinterpret_cast<unsigned*>(offset_ptr(_sq_ring, params.sq_off.array));
+  _cq_head = reinterpret_cast<unsigned*>(offset_ptr(_cq_ring, params.cq_off.head));
+  _cq_tail = reinterpret_cast<unsigned*>(offset_ptr(_cq_ring, params.cq_off.tail));
+  _cq_mask = reinterpret_cast<unsigned*>(offset_ptr(_cq_ring, params.cq_off.ring_mask));
+  _cqes = offset_ptr(_cq_ring, params.cq_off.cqes);
+}
+
+IoUring::~IoUring() {
+  ::munmap(_sqes, _sqes_size);
+  if (_cq_ring != _sq_ring) {
+    ::munmap(_cq_ring, _cq_ring_size);
+  }
+  ::munmap(_sq_ring, _sq_ring_size);
+  ::close(_ring_fd);
+}
+
+bool IoUring::prepare_read(int fd, char* dest, uint32_t size, uint64_t offset, uint64_t user_data) {
+  unsigned tail = *_sq_tail;
+  unsigned head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+  if (tail - head >= _sq_entries) {
+    return false;
+  }
+  unsigned index = tail & *_sq_mask;
+  auto* sqe = static_cast<io_uring_sqe*>(_sqes) + index;
+  std::memset(sqe, 0, sizeof(io_uring_sqe));
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(dest);
+  sqe->len = size;
+  sqe->off = offset;
+  sqe->user_data = user_data;
+  _sq_array[index] = index;
+  // the entry must be visible to the kernel before the tail is moved
+  __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+  _to_submit++;
+  return true;
+}
+
+void IoUring::submit(unsigned min_complete) {
+  unsigned flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+  while (_to_submit > 0 || min_complete > 0) {
+    int ret = io_uring_enter(_ring_fd, _to_submit, min_complete, flags);
+    if (ret < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+        continue;
+      }
+      throw std::system_error(errno, std::system_category(), "io_uring_enter");
+    }
+    _to_submit -= std::min(_to_submit, static_cast<unsigned>(ret));
+    // io_uring_enter only returns once min_complete completions are available (or it failed)
+    min_complete = 0;
+    flags = 0;
+  }
+}
+
+std::optional<IoUring::Completion> IoUring::pop_completion() {
+  unsigned head = *_cq_head;
+  if (head == __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+    return {};
+  }
+  const auto* cqe = static_cast<const io_uring_cqe*>(_cqes) + (head & *_cq_mask);
+  Completion completion{cqe->user_data, cqe->res};
+  // hand the entry back to the kernel
+  __atomic_store_n(_cq_head, head + 1, __ATOMIC_RELEASE);
+  return completion;
+}
+
+}  // namespace xs::utils
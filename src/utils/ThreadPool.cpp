@@ -0,0 +1,117 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <xsearch/utils/ThreadPool.h>
+
+#include <algorithm>
+
+namespace xs::utils {
+
+/// pool and worker index of the calling thread (nullptr if it is not a worker)
+static thread_local ThreadPool* current_pool = nullptr;
+static thread_local size_t current_worker = 0;
+
+ThreadPool::ThreadPool(size_t num_workers) {
+  if (num_workers == 0) {
+    num_workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+  for (size_t i = 0; i < num_workers; ++i) {
+    _workers.push_back(std::make_unique<Worker>());
+  }
+  for (size_t i = 0; i < num_workers; ++i) {
+    _threads.emplace_back(&ThreadPool::run_worker, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::unique_lock lock(_sleep_mutex);
+    _stop = true;
+  }
+  _sleep_cv.notify_all();
+  for (auto& thread : _threads) {
+    thread.join();
+  }
+}
+
+ThreadPool& ThreadPool::global() {
+  static ThreadPool pool;
+  return pool;
+}
+
+void ThreadPool::submit(task_type task) {
+  size_t index = current_pool == this ? current_worker : _next_worker.fetch_add(1) % _workers.size();
+  push(index, std::move(task), false);
+}
+
+void ThreadPool::yield(task_type task) {
+  if (current_pool != this) {
+    submit(std::move(task));
+    return;
+  }
+  push(current_worker, std::move(task), true);
+}
+
+void ThreadPool::push(size_t index, task_type task, bool front) {
+  // counted before the task is visible, so that it never drops below 0
+  _pending.fetch_add(1);
+  {
+    std::unique_lock lock(_workers[index]->mutex);
+    if (front) {
+      _workers[index]->tasks.push_front(std::move(task));
+    } else {
+      _workers[index]->tasks.push_back(std::move(task));
+    }
+  }
+  // a worker going to sleep increments _sleepers before it checks _pending: either it sees the task or we see it
+  if (_sleepers.load() > 0) {
+    std::unique_lock lock(_sleep_mutex);
+    _sleep_cv.notify_one();
+  }
+}
+
+bool ThreadPool::take(size_t index, task_type& task) {
+  {
+    Worker& own = *_workers[index];
+    std::unique_lock lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      _pending.fetch_sub(1);
+      return true;
+    }
+  }
+  for (size_t offset = 1; offset < _workers.size(); ++offset) {
+    Worker& victim = *_workers[(index + offset) % _workers.size()];
+    std::unique_lock lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      _pending.fetch_sub(1);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::run_worker(size_t index) {
+  current_pool = this;
+  current_worker = index;
+  task_type task;
+  while (true) {
+    if (take(index, task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+    std::unique_lock lock(_sleep_mutex);
+    _sleepers.fetch_add(1);
+    _sleep_cv.wait(lock, [this]() { return _pending.load() > 0 || _stop; });
+    _sleepers.fetch_sub(1);
+    if (_pending.load() == 0 && _stop) {
+      return;
+    }
+  }
+}
+
+}  // namespace xs::utils
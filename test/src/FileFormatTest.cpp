@@ -0,0 +1,121 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <lz4frame.h>
+#include <unistd.h>
+#include <xsearch/FileFormat.h>
+#include <zlib.h>
+#include <zstd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+static std::string test_path() { return (std::filesystem::temp_directory_path() / "xs_FileFormatTest").string(); }
+
+static std::string test_content() {
+  std::string content;
+  for (size_t i = 0; content.size() < (1 << 20); ++i) {
+    content.append("line ").append(std::to_string(i * 7919 % 100003)).append("\n");
+  }
+  return content;
+}
+
+static std::string zstd_compress(const std::string& data) {
+  std::string compressed(ZSTD_compressBound(data.size()), '\0');
+  compressed.resize(ZSTD_compress(compressed.data(), compressed.size(), data.data(), data.size(), 3));
+  return compressed;
+}
+
+static std::string lz4_frame_compress(const std::string& data) {
+  std::string compressed(LZ4F_compressFrameBound(data.size(), nullptr), '\0');
+  compressed.resize(LZ4F_compressFrame(compressed.data(), compressed.size(), data.data(), data.size(), nullptr));
+  return compressed;
+}
+
+static std::string gzip_compress(const std::string& data) {
+  z_stream strm{};
+  deflateInit2(&strm, 6, Z_DEFLATED, 31, 8, Z_DEFAULT_STRATEGY);
+  std::string compressed(deflateBound(&strm, data.size()), '\0');
+  strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  strm.avail_in = static_cast<uInt>(data.size());
+  strm.next_out = reinterpret_cast<Bytef*>(compressed.data());
+  strm.avail_out = static_cast<uInt>(compressed.size());
+  deflate(&strm, Z_FINISH);
+  compressed.resize(strm.total_out);
+  deflateEnd(&strm);
+  return compressed;
+}
+
+static void write_file(const std::string& path, const std::string& data) {
+  std::ofstream(path, std::ios::binary | std::ios::trunc).write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+/// decompress the file at path using a StreamDecoder, reading chunks of read_size bytes
+static std::string decode_file(const std::string& path, xs::FileFormat format, size_t read_size) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  std::string result;
+  try {
+    auto decoder = xs::StreamDecoder::create(format, fd);
+    std::string buffer(read_size, '\0');
+    while (true) {
+      size_t num_bytes = decoder->read(buffer.data(), read_size);
+      result.append(buffer.data(), num_bytes);
+      if (num_bytes < read_size) {
+        break;
+      }
+    }
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+  return result;
+}
+
+TEST(FileFormat, to_string) {
+  ASSERT_EQ(xs::to_string(xs::FileFormat::PLAIN), "PLAIN");
+  ASSERT_EQ(xs::to_string(xs::FileFormat::GZIP), "GZIP");
+  ASSERT_EQ(xs::to_string(xs::FileFormat::ZSTD), "ZSTD");
+  ASSERT_EQ(xs::to_string(xs::FileFormat::LZ4_FRAME), "LZ4_FRAME");
+}
+
+TEST(FileFormat, detect_format) {
+  std::string content = test_content();
+  ASSERT_EQ(xs::detect_format(content.data(), content.size()), xs::FileFormat::PLAIN);
+  ASSERT_EQ(xs::detect_format("", 0), xs::FileFormat::PLAIN);
+  ASSERT_EQ(xs::detect_format("\x1f\x8b", 2), xs::FileFormat::PLAIN);
+  for (auto [compressed, format] : {std::pair{gzip_compress(content), xs::FileFormat::GZIP},
+                                    {zstd_compress(content), xs::FileFormat::ZSTD},
+                                    {lz4_frame_compress(content), xs::FileFormat::LZ4_FRAME}}) {
+    ASSERT_EQ(xs::detect_format(compressed.data(), compressed.size()), format);
+    write_file(test_path(), compressed);
+    ASSERT_EQ(xs::detect_format(test_path()), format);
+  }
+  write_file(test_path(), "");
+  ASSERT_EQ(xs::detect_format(test_path()), xs::FileFormat::PLAIN);
+  std::filesystem::remove(test_path());
+  ASSERT_THROW(xs::detect_format(test_path()), std::runtime_error);
+}
+
+TEST(StreamDecoder, decodes_concatenated_frames) {
+  std::string content = test_content();
+  std::string half(content.data(), content.size() / 2);
+  std::string rest(content.data() + half.size(), content.size() - half.size());
+  for (auto [compressed, format] :
+       {std::pair{gzip_compress(half) + gzip_compress(rest), xs::FileFormat::GZIP},
+        {zstd_compress(half) + zstd_compress(rest), xs::FileFormat::ZSTD},
+        {lz4_frame_compress(half) + lz4_frame_compress(rest), xs::FileFormat::LZ4_FRAME}}) {
+    write_file(test_path(), compressed);
+    for (size_t read_size : {1000, 1 << 16, 1 << 22}) {
+      ASSERT_EQ(decode_file(test_path(), format, read_size), content);
+    }
+    // truncated data
+    write_file(test_path(), compressed.substr(0, compressed.size() - 100));
+    ASSERT_THROW(decode_file(test_path(), format, 1 << 16), std::runtime_error);
+  }
+  ASSERT_THROW(xs::StreamDecoder::create(xs::FileFormat::PLAIN, 0), std::runtime_error);
+  std::filesystem::remove(test_path());
+}
@@ -0,0 +1,175 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <gtest/gtest.h>
+#include <xsearch/MetaFile.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const std::string sample_meta_path(XS_TEST_FILES_DIR "/sample.meta");
+static const std::string zst_meta_path(XS_TEST_FILES_DIR "/sample.xszst.meta");
+
+static std::vector<xs::ChunkMetaData> test_chunks() {
+  std::vector<xs::ChunkMetaData> chunks;
+  uint64_t original_offset = 0;
+  uint64_t actual_offset = 0;
+  for (uint64_t i = 0; i < 100; ++i) {
+    xs::ChunkMetaData cmd{original_offset, actual_offset, 1000 + i, 500 + i, {}};
+    for (uint64_t j = 0; j < i % 7; ++j) {
+      cmd.line_mapping_data.push_back({original_offset + j * 100, i * 10 + j});
+    }
+    original_offset += cmd.original_size;
+    actual_offset += cmd.actual_size;
+    chunks.push_back(std::move(cmd));
+  }
+  return chunks;
+}
+
+TEST(MetaFile, to_string) {
+  ASSERT_EQ(xs::to_string(xs::CompressionType::NONE), "NONE");
+  ASSERT_EQ(xs::to_string(xs::CompressionType::ZSTD), "ZSTD");
+  ASSERT_EQ(xs::to_string(xs::CompressionType::LZ4), "LZ4");
+  ASSERT_EQ(xs::to_string(xs::CompressionType::MIXED), "MIXED");
+  ASSERT_EQ(xs::to_string(xs::CompressionType::UNKNOWN), "UNKNOWN");
+}
+
+TEST(MetaFile, read_sample) {
+  xs::MetaFile meta_file(sample_meta_path, std::ios::in);
+  ASSERT_EQ(meta_file.get_compression_type(), xs::CompressionType::NONE);
+  ASSERT_EQ(meta_file.num_chunks(), 6);
+
+  uint64_t original_offset = 0;
+  uint64_t line_index = 0;
+  size_t num_chunks = 0;
+  while (true) {
+    auto cmd = meta_file.next_chunk_meta_data();
+    if (!cmd) {
+      break;
+    }
+    ASSERT_EQ(cmd->original_offset, original_offset);
+    // uncompressed: actual and original locations are the same
+    ASSERT_EQ(cmd->actual_offset, cmd->original_offset);
+    ASSERT_EQ(cmd->actual_size, cmd->original_size);
+    ASSERT_FALSE(cmd->line_mapping_data.empty());
+    ASSERT_EQ(cmd->line_mapping_data.front().globalByteOffset, cmd->original_offset);
+    ASSERT_GE(cmd->line_mapping_data.front().globalLineIndex, line_index);
+    line_index = cmd->line_mapping_data.back().globalLineIndex;
+    original_offset += cmd->original_size;
+    num_chunks++;
+  }
+  ASSERT_EQ(num_chunks, 6);
+  ASSERT_FALSE(meta_file.next_chunk_meta_data().has_value());
+
+  xs::MetaFile zst_meta_file(zst_meta_path, std::ios::in);
+  ASSERT_EQ(zst_meta_file.get_compression_type(), xs::CompressionType::ZSTD);
+  ASSERT_EQ(zst_meta_file.num_chunks(), 6);
+  ASSERT_EQ(zst_meta_file.chunk_meta_data(5)->original_offset, meta_file.chunk_meta_data(5)->original_offset);
+}
+
+TEST(MetaFile, write_and_random_access) {
+  std::string path = (std::filesystem::temp_directory_path() / "xs_MetaFileTest.meta").string();
+  auto chunks = test_chunks();
+  {
+    xs::MetaFile meta_file(path, std::ios::out, xs::CompressionType::LZ4);
+    for (const auto& cmd : chunks) {
+      meta_file.write(cmd);
+    }
+  }
+  xs::MetaFile meta_file(path, std::ios::in);
+  ASSERT_EQ(meta_file.get_compression_type(), xs::CompressionType::LZ4);
+  ASSERT_EQ(meta_file.num_chunks(), chunks.size());
+  for (size_t i : {99, 0, 42, 7, 98}) {
+    ASSERT_EQ(meta_file.chunk_meta_data(i).value(), chunks[i]);
+  }
+  ASSERT_FALSE(meta_file.chunk_meta_data(100).has_value());
+
+  // concurrent sequential access: every chunk is handed out exactly once
+  std::vector<std::vector<xs::ChunkMetaData>> read(4);
+  std::vector<std::thread> threads;
+  for (auto& thread_read : read) {
+    threads.emplace_back([&meta_file, &thread_read]() {
+      while (auto cmd = meta_file.next_chunk_meta_data()) {
+        thread_read.push_back(std::move(cmd.value()));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  std::vector<xs::ChunkMetaData> all;
+  for (auto& thread_read : read) {
+    all.insert(all.end(), thread_read.begin(), thread_read.end());
+  }
+  std::sort(all.begin(), all.end(),
+            [](const auto& a, const auto& b) { return a.original_offset < b.original_offset; });
+  ASSERT_EQ(all, chunks);
+  std::filesystem::remove(path);
+}
+
+TEST(MetaFile, invalid_files) {
+  ASSERT_THROW(xs::MetaFile("/this/file/does/not/exist", std::ios::in), std::runtime_error);
+
+  std::string path = (std::filesystem::temp_directory_path() / "xs_MetaFileTest.meta").string();
+  {
+    xs::MetaFile meta_file(path, std::ios::out);
+    meta_file.write(test_chunks()[5]);
+  }
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+  ASSERT_THROW(xs::MetaFile(path, std::ios::in), std::runtime_error);
+  std::filesystem::remove(path);
+}
+
+TEST(MetaFile, dictionary) {
+  std::string path = (std::filesystem::temp_directory_path() / "xs_MetaFileTest.meta").string();
+  std::string dictionary = "some dictionary";
+  dictionary.push_back('\0');
+  dictionary.append("with binary content");
+  auto chunks = test_chunks();
+  {
+    xs::MetaFile meta_file(path, std::ios::out, xs::CompressionType::ZSTD, dictionary);
+    for (const auto& cmd : chunks) {
+      meta_file.write(cmd);
+    }
+  }
+  xs::MetaFile meta_file(path, std::ios::in);
+  ASSERT_EQ(meta_file.get_compression_type(), xs::CompressionType::ZSTD);
+  ASSERT_EQ(meta_file.dictionary(), dictionary);
+  ASSERT_EQ(meta_file.num_chunks(), chunks.size());
+  ASSERT_EQ(meta_file.chunk_meta_data(17).value(), chunks[17]);
+
+  // meta files without dictionary
+  xs::MetaFile sample(sample_meta_path, std::ios::in);
+  ASSERT_TRUE(sample.dictionary().empty());
+  std::filesystem::remove(path);
+}
+
+TEST(MetaFile, per_chunk_compression_type) {
+  std::string path = (std::filesystem::temp_directory_path() / "xs_MetaFileTest.meta").string();
+  auto chunks = test_chunks();
+  const xs::CompressionType types[] = {xs::CompressionType::NONE, xs::CompressionType::LZ4,
+                                       xs::CompressionType::ZSTD};
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    chunks[i].compression_type = types[i % 3];
+  }
+  {
+    xs::MetaFile meta_file(path, std::ios::out, xs::CompressionType::MIXED);
+    for (const auto& cmd : chunks) {
+      meta_file.write(cmd);
+    }
+    xs::ChunkMetaData invalid = chunks[0];
+    invalid.compression_type = xs::CompressionType::UNKNOWN;
+    ASSERT_THROW(meta_file.write(invalid), std::runtime_error);
+  }
+  xs::MetaFile meta_file(path, std::ios::in);
+  ASSERT_EQ(meta_file.get_compression_type(), xs::CompressionType::MIXED);
+  ASSERT_EQ(meta_file.num_chunks(), chunks.size());
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    ASSERT_EQ(meta_file.chunk_meta_data(i).value(), chunks[i]);
+  }
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,200 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <gtest/gtest.h>
+#include <xsearch/MetaFile.h>
+#include <xsearch/Preprocessor.h>
+#include <xsearch/tasks/readers.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static std::string temp_path(const std::string& name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+/// lines of varying length, some of them longer than the mapping distance
+static std::string write_input(const std::string& path) {
+  std::string content;
+  for (size_t i = 0; i < 20000; ++i) {
+    content.append("line " + std::to_string(i) + ": ");
+    content.append((i * 7919) % (i % 100 == 0 ? 2000 : 120), static_cast<char>('a' + i % 26));
+    content.push_back('\n');
+  }
+  content.append("last line without new line char");
+  std::ofstream(path, std::ios::binary) << content;
+  return content;
+}
+
+/// read all chunks of reader and check them (and their line mapping data) against content
+template <typename ReaderT>
+static void check_chunks(ReaderT& reader, const std::string& content) {
+  std::vector<uint64_t> line_begins = {0};
+  for (size_t pos = content.find('\n'); pos != std::string::npos; pos = content.find('\n', pos + 1)) {
+    line_begins.push_back(pos + 1);
+  }
+  std::string read;
+  while (auto chunk = reader()) {
+    ASSERT_EQ(chunk->offset(), read.size());
+    ASSERT_FALSE(chunk->line_mapping_data().empty());
+    for (const auto& point : chunk->line_mapping_data()) {
+      ASSERT_LT(point.globalLineIndex, line_begins.size());
+      ASSERT_EQ(line_begins[point.globalLineIndex], point.globalByteOffset);
+    }
+    read.append(chunk->data(), chunk->size());
+    if (read.size() < content.size()) {
+      ASSERT_EQ(read.back(), '\n');
+    }
+  }
+  ASSERT_EQ(read, content);
+}
+
+TEST(Preprocessor, compressed_chunks_can_be_read) {
+  std::string input_path = temp_path("xs_PreprocessorTest.txt");
+  std::string content = write_input(input_path);
+
+  for (auto algorithm : {xs::PreprocessOptions::Algorithm::LZ4, xs::PreprocessOptions::Algorithm::LZ4_HC,
+                         xs::PreprocessOptions::Algorithm::ZSTD}) {
+    for (size_t num_threads : {1, 4}) {
+      xs::PreprocessOptions options;
+      options.algorithm = algorithm;
+      options.chunk_size = 10000;
+      options.num_threads = num_threads;
+      std::string output_path = input_path + xs::file_extension(algorithm);
+      std::string meta_path = output_path + ".meta";
+      xs::preprocess(input_path, output_path, meta_path, options);
+
+      xs::MetaFile meta_file(meta_path, std::ios::in);
+      ASSERT_EQ(meta_file.get_compression_type(), xs::compression_type(algorithm));
+      ASSERT_GT(meta_file.num_chunks(), content.size() / 20000);
+      ASSERT_LT(std::filesystem::file_size(output_path), content.size());
+
+      if (algorithm == xs::PreprocessOptions::Algorithm::ZSTD) {
+        xs::ZstdChunkReader reader(output_path, meta_path);
+        check_chunks(reader, content);
+      } else {
+        xs::LZ4ChunkReader reader(output_path, meta_path);
+        check_chunks(reader, content);
+      }
+      std::filesystem::remove(output_path);
+      std::filesystem::remove(meta_path);
+    }
+  }
+  std::filesystem::remove(input_path);
+}
+
+TEST(Preprocessor, meta_file_of_uncompressed_input) {
+  std::string input_path = temp_path("xs_PreprocessorTest.txt");
+  std::string meta_path = input_path + ".meta";
+  std::string content = write_input(input_path);
+
+  xs::PreprocessOptions options;
+  options.algorithm = xs::PreprocessOptions::Algorithm::NONE;
+  options.chunk_size = 4096;
+  xs::preprocess(input_path, "", meta_path, options);
+
+  xs::ChunkReader reader(input_path, meta_path);
+  check_chunks(reader, content);
+  std::filesystem::remove(input_path);
+  std::filesystem::remove(meta_path);
+}
+
+TEST(Preprocessor, errors) {
+  ASSERT_THROW(xs::preprocess("/this/file/does/not/exist", temp_path("xs_PreprocessorTest.xslz4"),
+                              temp_path("xs_PreprocessorTest.xslz4.meta")),
+               std::runtime_error);
+  // compressed output requires an output file
+  ASSERT_THROW(xs::preprocess("-", "", temp_path("xs_PreprocessorTest.meta")), std::runtime_error);
+  std::filesystem::remove(temp_path("xs_PreprocessorTest.xslz4"));
+  std::filesystem::remove(temp_path("xs_PreprocessorTest.xslz4.meta"));
+}
+
+TEST(Preprocessor, zstd_dictionary) {
+  std::string input_path = temp_path("xs_PreprocessorTest.txt");
+  std::string content = write_input(input_path);
+
+  std::vector<uint64_t> compressed_sizes;
+  for (size_t dictionary_size : {0, 16384}) {
+    xs::PreprocessOptions options;
+    options.algorithm = xs::PreprocessOptions::Algorithm::ZSTD;
+    options.chunk_size = 4096;
+    options.dictionary_size = dictionary_size;
+    std::string output_path = input_path + ".xszst";
+    std::string meta_path = output_path + ".meta";
+    xs::preprocess(input_path, output_path, meta_path, options);
+    compressed_sizes.push_back(std::filesystem::file_size(output_path));
+
+    xs::MetaFile meta_file(meta_path, std::ios::in);
+    ASSERT_EQ(meta_file.get_compression_type(), xs::CompressionType::ZSTD);
+    ASSERT_EQ(meta_file.dictionary().empty(), dictionary_size == 0);
+    ASSERT_LE(meta_file.dictionary().size(), dictionary_size);
+
+    xs::ZstdChunkReader reader(output_path, meta_path);
+    ASSERT_EQ(reader.uses_dictionary(), dictionary_size > 0);
+    check_chunks(reader, content);
+    std::filesystem::remove(output_path);
+    std::filesystem::remove(meta_path);
+  }
+  // small chunks compress better with a dictionary
+  ASSERT_LT(compressed_sizes[1], compressed_sizes[0]);
+  std::filesystem::remove(input_path);
+}
+
+TEST(Preprocessor, adaptive_compression_per_chunk) {
+  // compressible lines followed by a block of random payload that no algorithm can compress
+  std::string input_path = temp_path("xs_PreprocessorTest.txt");
+  std::string content = write_input(input_path);
+  uint64_t state = 42;
+  for (size_t i = 0; i < 2000; ++i) {
+    for (size_t j = 0; j < 76; ++j) {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      content.push_back("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[state >> 58]);
+    }
+    content.push_back('\n');
+  }
+  std::ofstream(input_path, std::ios::binary | std::ios::trunc) << content;
+
+  xs::PreprocessOptions options;
+  options.algorithm = xs::PreprocessOptions::Algorithm::ADAPTIVE;
+  options.chunk_size = 10000;
+  options.num_threads = 4;
+  std::string output_path = input_path + xs::file_extension(options.algorithm);
+  std::string meta_path = output_path + ".meta";
+
+  // chunk compression types for the given decode costs
+  auto compression_types = [&](double lz4_decode_cost, double zstd_decode_cost) {
+    options.lz4_decode_cost = lz4_decode_cost;
+    options.zstd_decode_cost = zstd_decode_cost;
+    xs::preprocess(input_path, output_path, meta_path, options);
+    xs::MixedChunkReader reader(output_path, meta_path);
+    check_chunks(reader, content);
+    xs::MetaFile meta_file(meta_path, std::ios::in);
+    EXPECT_EQ(meta_file.get_compression_type(), xs::CompressionType::MIXED);
+    std::vector<xs::CompressionType> types;
+    for (size_t i = 0; i < meta_file.num_chunks(); ++i) {
+      types.push_back(meta_file.chunk_meta_data(i)->compression_type);
+    }
+    return types;
+  };
+
+  auto types = compression_types(0.1, 0.25);
+  // the payload is stored raw, the lines are compressed
+  ASSERT_EQ(types.back(), xs::CompressionType::NONE);
+  ASSERT_NE(types.front(), xs::CompressionType::NONE);
+  ASSERT_LT(std::filesystem::file_size(output_path), content.size());
+
+  types = compression_types(0, 0);
+  ASSERT_TRUE(std::none_of(types.begin(), types.end(), [](auto type) { return type == xs::CompressionType::NONE; }));
+  types = compression_types(0, 10);
+  ASSERT_TRUE(std::none_of(types.begin(), types.end(), [](auto type) { return type == xs::CompressionType::ZSTD; }));
+  types = compression_types(10, 10);
+  ASSERT_TRUE(std::all_of(types.begin(), types.end(), [](auto type) { return type == xs::CompressionType::NONE; }));
+  ASSERT_EQ(std::filesystem::file_size(output_path), content.size());
+
+  std::filesystem::remove(input_path);
+  std::filesystem::remove(output_path);
+  std::filesystem::remove(meta_path);
+}
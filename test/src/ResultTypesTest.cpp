@@ -0,0 +1,60 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <gtest/gtest.h>
+#include <xsearch/ResultTypes.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using xs::OrderedResult;
+using xs::PartRes1;
+
+TEST(OrderedResult, releases_partial_results_in_sequence_order) {
+  OrderedResult<PartRes1<int>> result;
+  result.add(2, PartRes1<int>{2});
+  result.add(1, std::nullopt);
+  ASSERT_EQ(result.size(), 0);
+  ASSERT_EQ(result.num_pending(), 2);
+  result.add(0, PartRes1<int>{0});
+  // 1 had no partial result: 0 and 2 are released at once
+  ASSERT_EQ(result.size(), 2);
+  ASSERT_EQ(result.num_pending(), 0);
+  result.add(4, PartRes1<int>{4});
+  result.add(3, PartRes1<int>{3});
+  result.close();
+  std::vector<int> values;
+  for (const auto& partial_result : result) {
+    values.insert(values.end(), partial_result.begin(), partial_result.end());
+  }
+  ASSERT_EQ(values, (std::vector<int>{0, 2, 3, 4}));
+}
+
+TEST(OrderedResult, close_flushes_pending_results) {
+  OrderedResult<PartRes1<int>> result;
+  result.add(3, PartRes1<int>{3});
+  result.add(1, PartRes1<int>{1});
+  result.close();
+  ASSERT_EQ(result.size(), 2);
+  ASSERT_EQ(result[0], PartRes1<int>{1});
+  ASSERT_EQ(result[1], PartRes1<int>{3});
+  ASSERT_FALSE(result.add(0, PartRes1<int>{0}));
+}
+
+TEST(OrderedResult, window_blocks_results_too_far_ahead) {
+  OrderedResult<PartRes1<int>> result(2);
+  result.add(1, PartRes1<int>{1});
+  std::atomic<bool> added = false;
+  std::thread ahead([&]() {
+    result.add(2, PartRes1<int>{2});
+    added = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ASSERT_FALSE(added.load());
+  result.add(0, PartRes1<int>{0});
+  ahead.join();
+  ASSERT_TRUE(added.load());
+  ASSERT_EQ(result.size(), 3);
+}
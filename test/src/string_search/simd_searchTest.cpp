@@ -40,6 +40,15 @@ TEST(simd_searchTest, strchr) {
   ASSERT_EQ(simd::strchr(dummy_text, 1240, '\2'), strchr(dummy_text, '\2'));
 }
 
+TEST(simd_searchTest, strrchr) {
+  ASSERT_EQ(simd::strrchr(dummy_text, 1240, 'L'), strrchr(dummy_text, 'L'));
+  ASSERT_EQ(simd::strrchr(dummy_text, 1240, '\n'), strrchr(dummy_text, '\n'));
+  ASSERT_EQ(simd::strrchr(dummy_text, 1240, '\1'), strrchr(dummy_text, '\1'));
+  ASSERT_EQ(simd::strrchr(dummy_text, 1240, '\2'), strrchr(dummy_text, '\2'));
+  ASSERT_EQ(simd::strrchr(dummy_text, 20, 'L'), dummy_text);
+  ASSERT_EQ(simd::strrchr(dummy_text, 0, 'L'), nullptr);
+}
+
 TEST(simd_searchTest, strstr) {
   ASSERT_EQ(simd::strstr(dummy_text, 1240, "Liane", 5),
             strstr(dummy_text, "Liane"));
@@ -80,6 +89,13 @@ TEST(simd_searchTest, findNextNewLine) {
   ASSERT_EQ(simd::findNextNewLine(dummy_text, 1240, 729), -1);
 }
 
+TEST(simd_searchTest, findLastNewLine) {
+  ASSERT_EQ(simd::findLastNewLine(dummy_text, 1240), 728);
+  ASSERT_EQ(simd::findLastNewLine(dummy_text, 728), 282);
+  ASSERT_EQ(simd::findLastNewLine(dummy_text, 283), 282);
+  ASSERT_EQ(simd::findLastNewLine(dummy_text, 223), -1);
+}
+
 TEST(simd_searchTest, findAllPerLine) {
   ASSERT_EQ(simd::findAllPerLine("is", 2, dummy_text, 1240), 2);
   ASSERT_EQ(simd::findAllPerLine("th", 2, dummy_text, 1240), 3);
@@ -0,0 +1,976 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <gtest/gtest.h>
+#include <lz4.h>
+#include <lz4frame.h>
+#include <xsearch/Searcher.h>
+#include <xsearch/string_search/search_wrappers.h>
+#include <xsearch/tasks/readers.h>
+#include <xsearch/tasks/searchers.h>
+#include <zlib.h>
+#include <zstd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <tuple>
+
+#include "test_utils.h"
+
+static std::string test_file_path() {
+  return (std::filesystem::temp_directory_path() / "xs_readersTest.txt").string();
+}
+
+TEST(FileReader, reads_all_bytes) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 100);
+
+  xs::FileReader reader(path, 1000);
+  std::string read;
+  while (true) {
+    auto chunk = reader();
+    if (!chunk) {
+      break;
+    }
+    ASSERT_LE(chunk->size(), 1000);
+    read.append(chunk->data(), chunk->size());
+  }
+  ASSERT_EQ(read, content);
+  std::filesystem::remove(path);
+}
+
+TEST(FileReader, newline_aligned_chunks) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 100);
+  // a line that is longer than a chunk
+  content.append(2500, 'x');
+  content.append("\nlast line without new line char");
+  std::ofstream(path, std::ios::binary | std::ios::app) << std::string(2500, 'x') << "\nlast line without new line char";
+
+  for (size_t chunk_size : {16, 1000, 4096, 1 << 20}) {
+    xs::FileReader reader(path, chunk_size, true);
+    std::string read;
+    uint64_t num_matches = 0;
+    while (true) {
+      auto chunk = reader();
+      if (!chunk) {
+        break;
+      }
+      read.append(chunk->data(), chunk->size());
+      if (read.size() < content.size()) {
+        ASSERT_EQ(chunk->back(), '\n');
+      }
+      num_matches += xs::search::count(*chunk, "ant");
+    }
+    ASSERT_EQ(read, content);
+    // no line is split between two chunks: all matches are found
+    ASSERT_EQ(num_matches, 400);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(FileReader, recycles_chunk_buffers) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 100);
+
+  for (bool align_to_newline : {false, true}) {
+    xs::FileReader reader(path, 1000, align_to_newline);
+    auto first = reader();
+    ASSERT_TRUE(first.has_value());
+    const char* buffer = first->data();
+    std::string read(first->data(), first->size());
+    reader.recycle(std::move(first.value()));
+    while (true) {
+      auto chunk = reader();
+      if (!chunk) {
+        break;
+      }
+      // the recycled buffer is reused instead of allocating a new one
+      ASSERT_EQ(chunk->data(), buffer);
+      read.append(chunk->data(), chunk->size());
+      reader.recycle(std::move(chunk.value()));
+    }
+    ASSERT_EQ(read, content);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(FileReader, read_ahead) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 1000);
+
+  for (bool align_to_newline : {false, true}) {
+    xs::FileReader reader(path, 4096, align_to_newline, 64, 8);
+    ASSERT_GE(reader.read_ahead_window(), 1);
+    std::string read;
+    while (true) {
+      auto chunk = reader();
+      if (!chunk) {
+        break;
+      }
+      read.append(chunk->data(), chunk->size());
+      ASSERT_GE(reader.read_ahead_window(), 1);
+      ASSERT_LE(reader.read_ahead_window(), 8);
+    }
+    ASSERT_EQ(read, content);
+  }
+  ASSERT_EQ(xs::FileReader(path).read_ahead_window(), 0);
+  std::filesystem::remove(path);
+}
+
+TEST(MmapFileReader, reads_all_bytes) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 100);
+
+  xs::MmapFileReader reader(path, 1000);
+  ASSERT_EQ(reader.size(), content.size());
+  std::string read;
+  uint64_t expected_offset = 0;
+  while (true) {
+    auto chunk = reader();
+    if (!chunk) {
+      break;
+    }
+    ASSERT_LE(chunk->size(), 1000);
+    ASSERT_EQ(chunk->offset(), expected_offset);
+    expected_offset += chunk->size();
+    read.append(chunk->data(), chunk->size());
+  }
+  ASSERT_EQ(read, content);
+  // exhausted readers keep returning nothing
+  ASSERT_FALSE(reader().has_value());
+  std::filesystem::remove(path);
+}
+
+TEST(MmapFileReader, empty_and_missing_file) {
+  std::string path = test_file_path();
+  write_test_file(path, 0);
+  xs::MmapFileReader reader(path);
+  ASSERT_FALSE(reader().has_value());
+  std::filesystem::remove(path);
+
+  ASSERT_THROW(xs::MmapFileReader("/this/file/does/not/exist"), std::runtime_error);
+}
+
+TEST(MmapFileReader, global_offsets_in_searcher) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 1000);
+
+  std::vector<uint64_t> expected;
+  for (size_t pos = content.find("ant"); pos != std::string::npos; pos = content.find("ant", pos + 3)) {
+    expected.push_back(pos);
+  }
+
+  xs::Searcher<xs::MmapFileReader<>, xs::IndexSearcher<xs::DataView>, xs::Result<xs::PartRes1<uint64_t>>,
+               xs::PartRes1<uint64_t>, void, xs::DataView>
+      searcher(xs::MmapFileReader<>(path, 4096), xs::IndexSearcher<xs::DataView>("ant"), 4);
+  auto& result = searcher.execute<xs::execute::blocking>().get();
+
+  std::vector<uint64_t> found;
+  for (const auto& partial_result : result.get()) {
+    found.insert(found.end(), partial_result.begin(), partial_result.end());
+  }
+  std::sort(found.begin(), found.end());
+  // matches crossing a chunk boundary are not found with fixed size chunks
+  ASSERT_LE(found.size(), expected.size());
+  ASSERT_TRUE(std::includes(expected.begin(), expected.end(), found.begin(), found.end()));
+  std::filesystem::remove(path);
+}
+
+TEST(PReadFileReader, chunks_cover_file) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 100);
+  content.append(2500, 'x');
+  content.append("\nlast line without new line char");
+  std::ofstream(path, std::ios::binary | std::ios::app) << std::string(2500, 'x') << "\nlast line without new line char";
+
+  for (bool align_to_newline : {false, true}) {
+    for (size_t chunk_size : {16, 1000, 4096, 1 << 20}) {
+      xs::PReadFileReader reader(path, chunk_size, align_to_newline);
+      ASSERT_EQ(reader.size(), content.size());
+      std::string read;
+      uint64_t sequence_number = 0;
+      while (true) {
+        auto chunk = reader();
+        if (!chunk) {
+          break;
+        }
+        // called by a single thread, chunks are returned in order. Chunks within a long line are empty
+        if (!chunk->empty()) {
+          ASSERT_EQ(chunk->offset(), read.size());
+        }
+        ASSERT_EQ(chunk->sequence_number(), sequence_number++);
+        read.append(chunk->data(), chunk->size());
+        if (align_to_newline && !chunk->empty() && read.size() < content.size()) {
+          ASSERT_EQ(chunk->back(), '\n');
+        }
+        reader.recycle(std::move(chunk.value()));
+      }
+      ASSERT_EQ(sequence_number, (content.size() + chunk_size - 1) / chunk_size);
+      ASSERT_EQ(read, content);
+    }
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(PReadFileReader, file_without_new_line_chars) {
+  std::string path = test_file_path();
+  // many chunks long: every chunk only searches its own bytes for a line begin, the first chunk owns the whole file
+  std::string content(64 * 4096 + 100, 'x');
+  std::ofstream(path, std::ios::binary) << content;
+
+  xs::PReadFileReader reader(path, 4096, true);
+  std::string read;
+  size_t num_chunks = 0;
+  while (auto chunk = reader()) {
+    if (num_chunks++ > 0) {
+      ASSERT_TRUE(chunk->empty());
+    }
+    read.append(chunk->data(), chunk->size());
+  }
+  ASSERT_EQ(num_chunks, 65);
+  ASSERT_EQ(read, content);
+
+  // the line ends within the last chunk: the next line starts there
+  content.append("\nant\n");
+  std::ofstream(path, std::ios::binary | std::ios::app) << "\nant\n";
+  xs::PReadFileReader line_reader(path, 4096, true);
+  std::vector<std::string> chunks;
+  while (auto chunk = line_reader()) {
+    chunks.emplace_back(chunk->data(), chunk->size());
+  }
+  ASSERT_EQ(chunks.size(), 65);
+  ASSERT_EQ(chunks.front(), content.substr(0, 64 * 4096 + 101));
+  ASSERT_EQ(chunks.back(), "ant\n");
+  std::filesystem::remove(path);
+}
+
+TEST(PReadFileReader, concurrent_reads_in_searcher) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 1000);
+
+  std::vector<uint64_t> expected = expected_line_offsets(content);
+
+  xs::Searcher<xs::PReadFileReader<>, xs::LineIndexSearcher<xs::DataChunk>, xs::Result<xs::PartRes1<uint64_t>>,
+               xs::PartRes1<uint64_t>, void, xs::DataChunk>
+      searcher(xs::PReadFileReader<>(path, 4096, true), xs::LineIndexSearcher<xs::DataChunk>("ant"), 4);
+  auto& result = searcher.execute<xs::execute::blocking>().get();
+
+  std::vector<uint64_t> found;
+  for (const auto& partial_result : result.get()) {
+    found.insert(found.end(), partial_result.begin(), partial_result.end());
+  }
+  std::sort(found.begin(), found.end());
+  ASSERT_EQ(found, expected);
+  std::filesystem::remove(path);
+}
+
+TEST(IoUringReader, chunks_cover_file) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 100);
+
+  for (unsigned queue_depth : {1, 4, 64}) {
+    xs::IoUringReader reader(path, 1000, queue_depth);
+    std::vector<std::pair<uint64_t, std::string>> chunks;
+    while (true) {
+      auto chunk = reader();
+      if (!chunk) {
+        break;
+      }
+      chunks.emplace_back(chunk->offset(), std::string(chunk->data(), chunk->size()));
+      reader.recycle(std::move(chunk.value()));
+    }
+    // chunks are returned in the order their reads complete
+    std::sort(chunks.begin(), chunks.end());
+    std::string read;
+    for (const auto& [offset, data] : chunks) {
+      ASSERT_EQ(offset, read.size());
+      read.append(data);
+    }
+    ASSERT_EQ(read, content);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(IoUringReader, missing_file) {
+  // thrown by both backends (io_uring and the xs::FileReader fallback)
+  ASSERT_THROW(xs::IoUringReader<>("/nonexistent/xs_readersTest.txt"), std::runtime_error);
+}
+
+TEST(IoUringReader, concurrent_reads_in_searcher) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 1000);
+
+  std::vector<uint64_t> expected;
+  for (size_t pos = content.find("ant"); pos != std::string::npos; pos = content.find("ant", pos + 3)) {
+    expected.push_back(pos);
+  }
+
+  xs::Searcher<xs::IoUringReader<>, xs::IndexSearcher<xs::DataChunk>, xs::Result<xs::PartRes1<uint64_t>>,
+               xs::PartRes1<uint64_t>, void, xs::DataChunk>
+      searcher(xs::IoUringReader<>(path, 4096, 8), xs::IndexSearcher<xs::DataChunk>("ant"), 4);
+  auto& result = searcher.execute<xs::execute::blocking>().get();
+
+  std::vector<uint64_t> found;
+  for (const auto& partial_result : result.get()) {
+    found.insert(found.end(), partial_result.begin(), partial_result.end());
+  }
+  std::sort(found.begin(), found.end());
+  // matches crossing a chunk boundary are not found with fixed size chunks
+  ASSERT_TRUE(std::includes(expected.begin(), expected.end(), found.begin(), found.end()));
+  ASSERT_GT(found.size(), expected.size() * 9 / 10);
+  std::filesystem::remove(path);
+}
+
+TEST(DirectFileReader, chunks_cover_file) {
+  std::string path = test_file_path();
+  // not a multiple of the alignment: the last block is unaligned
+  std::string content = write_test_file(path, 1000);
+  ASSERT_NE(content.size() % 4096, 0);
+
+  for (bool direct_io : {true, false}) {
+    xs::DirectFileReader reader(path, 10000, direct_io);
+    std::string read;
+    while (true) {
+      auto chunk = reader();
+      if (!chunk) {
+        break;
+      }
+      ASSERT_EQ(chunk->offset(), read.size());
+      ASSERT_EQ(reinterpret_cast<uintptr_t>(chunk->data()) % 4096, 0);
+      read.append(chunk->data(), chunk->size());
+      reader.recycle(std::move(chunk.value()));
+    }
+    ASSERT_EQ(read, content);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(DirectFileReader, falls_back_if_reads_are_rejected) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 1000);
+
+  // O_DIRECT reads at offsets that are not multiples of the logical block size fail with EINVAL
+  xs::DirectFileReader reader(path, 1000, true, 1);
+  std::string read;
+  while (true) {
+    auto chunk = reader();
+    if (!chunk) {
+      break;
+    }
+    ASSERT_EQ(chunk->offset(), read.size());
+    read.append(chunk->data(), chunk->size());
+    reader.recycle(std::move(chunk.value()));
+  }
+  ASSERT_EQ(read, content);
+  ASSERT_FALSE(reader.is_direct());
+
+  // AlignedDataChunk buffers are aligned to 4096 bytes
+  ASSERT_THROW(xs::DirectFileReader(path, 16384, true, 8192), std::runtime_error);
+  std::filesystem::remove(path);
+}
+
+TEST(StreamReader, pipe_in_searcher) {
+  std::string content;
+  for (size_t i = 0; i < 1000; ++i) {
+    for (const auto& line : lines) {
+      content.append(line);
+    }
+  }
+  std::vector<uint64_t> expected = expected_line_offsets(content);
+
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  // write the content in small pieces: the reader has to deal with short reads
+  std::thread writer([&]() {
+    for (size_t pos = 0; pos < content.size(); pos += 777) {
+      size_t size = std::min<size_t>(777, content.size() - pos);
+      ASSERT_EQ(write(fds[1], content.data() + pos, size), static_cast<ssize_t>(size));
+    }
+    close(fds[1]);
+  });
+
+  {
+    xs::Searcher<xs::StreamReader<>, xs::LineIndexSearcher<xs::DataChunk>, xs::Result<xs::PartRes1<uint64_t>>,
+                 xs::PartRes1<uint64_t>, void, xs::DataChunk>
+        searcher(xs::StreamReader<>(fds[0], 4096), xs::LineIndexSearcher<xs::DataChunk>("ant"), 4);
+    auto& result = searcher.execute<xs::execute::blocking>().get();
+
+    std::vector<uint64_t> found;
+    for (const auto& partial_result : result.get()) {
+      found.insert(found.end(), partial_result.begin(), partial_result.end());
+    }
+    std::sort(found.begin(), found.end());
+    ASSERT_EQ(found, expected);
+  }
+  writer.join();
+  close(fds[0]);
+}
+
+TEST(MultiFileReader, directory_search_tags_file_ids) {
+  namespace fs = std::filesystem;
+  fs::path root = fs::temp_directory_path() / "xs_readersTest_dir";
+  fs::remove_all(root);
+  fs::create_directories(root / "a" / "b");
+  fs::create_directories(root / "c");
+  // symlinked directories are not followed
+  fs::create_directory_symlink(root, root / "c" / "loop");
+
+  std::vector<std::tuple<std::string, uint64_t>> expected;
+  auto add_file = [&](const fs::path& path, size_t num_repetitions) {
+    std::string content = write_test_file(path.string(), num_repetitions);
+    for (uint64_t offset : expected_line_offsets(content)) {
+      expected.emplace_back(path.string(), offset);
+    }
+  };
+  for (size_t i = 0; i < 60; ++i) {
+    add_file(root / (i % 3 == 0 ? "a" : (i % 3 == 1 ? "a/b" : "c")) / ("small" + std::to_string(i)), i % 4);
+  }
+  add_file(root / "a" / "large", 1000);
+  std::sort(expected.begin(), expected.end());
+
+  xs::MultiFileReader reader({root.string()}, 4096);
+  auto files = reader.files();
+  ASSERT_EQ(files->size(), 61);
+  // small files are batched, the large file is split
+  ASSERT_LT(reader.num_tasks(), (fs::file_size(root / "a" / "large") + 4095) / 4096 + 60);
+
+  using searcher_t = xs::MultiFileSearcher<xs::LineIndexSearcher<xs::DataView>>;
+  xs::Searcher<xs::MultiFileReader<>, searcher_t, xs::Result<searcher_t::result_type>, searcher_t::result_type, void,
+               xs::MultiFileChunk>
+      searcher(std::move(reader), searcher_t(xs::LineIndexSearcher<xs::DataView>("ant")), 4);
+  auto& result = searcher.execute<xs::execute::blocking>().get();
+
+  std::vector<std::tuple<std::string, uint64_t>> found;
+  for (const auto& partial_result : result.get()) {
+    for (const auto& [file_id, offset] : partial_result) {
+      found.emplace_back((*files)[file_id].path, offset);
+    }
+  }
+  std::sort(found.begin(), found.end());
+  ASSERT_EQ(found, expected);
+  fs::remove_all(root);
+}
+
+TEST(MultiFileReader, split_file_without_new_line_chars) {
+  namespace fs = std::filesystem;
+  fs::path root = fs::temp_directory_path() / "xs_readersTest_dir";
+  fs::remove_all(root);
+  fs::create_directories(root);
+  std::string content(32 * 4096 + 100, 'x');
+  std::ofstream(root / "long_line", std::ios::binary) << content;
+
+  xs::MultiFileReader reader({root.string()}, 4096);
+  ASSERT_EQ(reader.num_tasks(), 33);
+  std::string read;
+  while (auto chunk = reader()) {
+    for (const auto& segment : chunk->segments()) {
+      ASSERT_EQ(segment.file_offset, read.size());
+      read.append(chunk->data() + segment.begin, segment.size);
+    }
+  }
+  ASSERT_EQ(read, content);
+  fs::remove_all(root);
+}
+
+TEST(MultiFileReader, vanished_file_throws) {
+  namespace fs = std::filesystem;
+  fs::path root = fs::temp_directory_path() / "xs_readersTest_dir";
+  fs::remove_all(root);
+  fs::create_directories(root);
+  write_test_file((root / "kept").string(), 1);
+  write_test_file((root / "vanished").string(), 1);
+
+  xs::MultiFileReader reader({root.string()}, 4096);
+  ASSERT_EQ(reader.num_tasks(), 1);
+  fs::remove(root / "vanished");
+  ASSERT_THROW(reader(), std::runtime_error);
+  fs::remove_all(root);
+}
+
+TEST(FileReader, autotune_in_searcher) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 2000);
+
+  std::vector<uint64_t> expected = expected_line_offsets(content);
+
+  xs::FileReader<xs::DataChunk> reader(path, 4096, true);
+  auto tuner = reader.autotune(4, 1024);
+  xs::Searcher<xs::FileReader<xs::DataChunk>, xs::LineIndexSearcher<xs::DataChunk>,
+               xs::Result<xs::PartRes1<uint64_t>>, xs::PartRes1<uint64_t>, void, xs::DataChunk>
+      searcher(std::move(reader), xs::LineIndexSearcher<xs::DataChunk>("ant"), 4);
+  auto& result = searcher.execute<xs::execute::blocking>().get();
+
+  std::vector<uint64_t> found;
+  for (const auto& partial_result : result.get()) {
+    found.insert(found.end(), partial_result.begin(), partial_result.end());
+  }
+  std::sort(found.begin(), found.end());
+  ASSERT_EQ(found, expected);
+
+  // at least four chunks per thread
+  ASSERT_GE(tuner->chunk_size(), 1024);
+  ASSERT_LE(tuner->chunk_size(), content.size() / 16);
+  ASSERT_FALSE(tuner->history().empty());
+  ASSERT_EQ(tuner->history().front().chunk_size, 4096);
+  std::filesystem::remove(path);
+}
+
+TEST(ChunkReader, chunks_from_meta_file) {
+  std::string path = test_file_path();
+  std::string meta_path = path + ".meta";
+  std::string content = write_test_file(path, 1000);
+
+  // newline aligned chunks of about 4000 bytes, mapping points at the chunk begin and every 10 lines
+  {
+    xs::MetaFile meta_file(meta_path, std::ios::out, xs::CompressionType::NONE);
+    uint64_t line_index = 0;
+    for (uint64_t begin = 0; begin < content.size();) {
+      uint64_t end = std::min<uint64_t>(content.find('\n', begin + 4000), content.size() - 1) + 1;
+      xs::ChunkMetaData cmd{begin, begin, end - begin, end - begin, {}};
+      for (uint64_t line_begin = begin; line_begin < end; line_begin = content.find('\n', line_begin) + 1) {
+        if (line_begin == begin || line_index % 10 == 0) {
+          cmd.line_mapping_data.push_back({line_begin, line_index});
+        }
+        line_index++;
+      }
+      meta_file.write(cmd);
+      begin = end;
+    }
+  }
+
+  xs::ChunkReader reader(path, meta_path);
+  ASSERT_GT(reader.num_chunks(), 100);
+  std::string read;
+  while (true) {
+    auto chunk = reader();
+    if (!chunk) {
+      break;
+    }
+    ASSERT_EQ(chunk->offset(), read.size());
+    // line indices from the mapping data match the counted ones
+    for (uint64_t pos : {chunk->offset(), chunk->offset() + chunk->size() / 2, chunk->offset() + chunk->size() - 1}) {
+      ASSERT_EQ(chunk->line_index(pos), std::count(content.begin(), content.begin() + pos, '\n'));
+    }
+    read.append(chunk->data(), chunk->size());
+    reader.recycle(std::move(chunk.value()));
+  }
+  ASSERT_EQ(read, content);
+
+  std::vector<uint64_t> expected = expected_line_offsets(content);
+  xs::Searcher<xs::ChunkReader<>, xs::LineIndexSearcher<xs::LineMappedDataChunk>, xs::Result<xs::PartRes1<uint64_t>>,
+               xs::PartRes1<uint64_t>, void, xs::LineMappedDataChunk>
+      searcher(xs::ChunkReader<>(path, meta_path), xs::LineIndexSearcher<xs::LineMappedDataChunk>("ant"), 4);
+  auto& result = searcher.execute<xs::execute::blocking>().get();
+  std::vector<uint64_t> found;
+  for (const auto& partial_result : result.get()) {
+    found.insert(found.end(), partial_result.begin(), partial_result.end());
+  }
+  std::sort(found.begin(), found.end());
+  ASSERT_EQ(found, expected);
+
+  ASSERT_THROW(xs::ChunkReader(path, path), std::runtime_error);
+  std::filesystem::remove(path);
+  std::filesystem::remove(meta_path);
+}
+
+/**
+ * Split content into newline aligned chunks of about chunk_size bytes, compress them using compress and write the
+ *  compressed file and its meta file.
+ */
+static void write_compressed_file(const std::string& content, const std::string& path, const std::string& meta_path,
+                                  xs::CompressionType compression_type, size_t chunk_size,
+                                  const std::function<std::string(const char*, size_t)>& compress) {
+  std::ofstream out(path, std::ios::binary);
+  xs::MetaFile meta_file(meta_path, std::ios::out, compression_type);
+  uint64_t actual_offset = 0;
+  uint64_t line_index = 0;
+  for (uint64_t begin = 0; begin < content.size();) {
+    uint64_t end = std::min<uint64_t>(content.find('\n', begin + chunk_size), content.size() - 1) + 1;
+    std::string compressed = compress(content.data() + begin, end - begin);
+    out.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+    xs::ChunkMetaData cmd{begin, actual_offset, end - begin, compressed.size(), {{begin, line_index}}};
+    meta_file.write(cmd);
+    line_index += std::count(content.begin() + static_cast<int64_t>(begin), content.begin() + static_cast<int64_t>(end),
+                             '\n');
+    actual_offset += compressed.size();
+    begin = end;
+  }
+}
+
+TEST(LZ4ChunkReader, decompresses_chunks_in_searcher) {
+  std::string path = test_file_path() + ".xslz4";
+  std::string meta_path = path + ".meta";
+  std::string content = write_test_file(test_file_path(), 1000);
+  write_compressed_file(content, path, meta_path, xs::CompressionType::LZ4, 8000, [](const char* data, size_t size) {
+    std::string compressed(LZ4_compressBound(static_cast<int>(size)), '\0');
+    compressed.resize(LZ4_compress_default(data, compressed.data(), static_cast<int>(size),
+                                           static_cast<int>(compressed.size())));
+    return compressed;
+  });
+
+  xs::LZ4ChunkReader reader(path, meta_path);
+  std::string read;
+  while (auto chunk = reader()) {
+    ASSERT_EQ(chunk->offset(), read.size());
+    ASSERT_EQ(chunk->line_index(chunk->offset()), std::count(content.begin(), content.begin() + read.size(), '\n'));
+    read.append(chunk->data(), chunk->size());
+    reader.recycle(std::move(chunk.value()));
+  }
+  ASSERT_EQ(read, content);
+
+  std::vector<uint64_t> expected = expected_line_offsets(content);
+  xs::Searcher<xs::LZ4ChunkReader<>, xs::LineIndexSearcher<xs::LineMappedDataChunk>,
+               xs::Result<xs::PartRes1<uint64_t>>, xs::PartRes1<uint64_t>, void, xs::LineMappedDataChunk>
+      searcher(xs::LZ4ChunkReader<>(path, meta_path), xs::LineIndexSearcher<xs::LineMappedDataChunk>("ant"), 4);
+  auto& result = searcher.execute<xs::execute::blocking>().get();
+  std::vector<uint64_t> found;
+  for (const auto& partial_result : result.get()) {
+    found.insert(found.end(), partial_result.begin(), partial_result.end());
+  }
+  std::sort(found.begin(), found.end());
+  ASSERT_EQ(found, expected);
+
+  // not LZ4 compressed
+  xs::MetaFile(meta_path, std::ios::out, xs::CompressionType::NONE);
+  ASSERT_THROW(xs::LZ4ChunkReader(path, meta_path), std::runtime_error);
+  std::filesystem::remove(test_file_path());
+  std::filesystem::remove(path);
+  std::filesystem::remove(meta_path);
+}
+
+TEST(ZstdChunkReader, decompresses_chunks_in_searcher) {
+  std::string path = test_file_path() + ".xszst";
+  std::string meta_path = path + ".meta";
+  std::string content = write_test_file(test_file_path(), 1000);
+  write_compressed_file(content, path, meta_path, xs::CompressionType::ZSTD, 8000, [](const char* data, size_t size) {
+    std::string compressed(ZSTD_compressBound(size), '\0');
+    compressed.resize(ZSTD_compress(compressed.data(), compressed.size(), data, size, 3));
+    return compressed;
+  });
+
+  xs::ZstdChunkReader reader(path, meta_path);
+  std::string read;
+  while (auto chunk = reader()) {
+    ASSERT_EQ(chunk->offset(), read.size());
+    read.append(chunk->data(), chunk->size());
+    reader.recycle(std::move(chunk.value()));
+  }
+  ASSERT_EQ(read, content);
+
+  std::vector<uint64_t> expected = expected_line_offsets(content);
+  xs::Searcher<xs::ZstdChunkReader<>, xs::LineIndexSearcher<xs::LineMappedDataChunk>,
+               xs::Result<xs::PartRes1<uint64_t>>, xs::PartRes1<uint64_t>, void, xs::LineMappedDataChunk>
+      searcher(xs::ZstdChunkReader<>(path, meta_path), xs::LineIndexSearcher<xs::LineMappedDataChunk>("ant"), 4);
+  auto& result = searcher.execute<xs::execute::blocking>().get();
+  std::vector<uint64_t> found;
+  for (const auto& partial_result : result.get()) {
+    found.insert(found.end(), partial_result.begin(), partial_result.end());
+  }
+  std::sort(found.begin(), found.end());
+  ASSERT_EQ(found, expected);
+
+  // corrupted data
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 10);
+  std::fstream(path, std::ios::binary | std::ios::in | std::ios::out).write("garbage", 7);
+  xs::ZstdChunkReader corrupted(path, meta_path);
+  ASSERT_THROW(corrupted(), std::runtime_error);
+  std::filesystem::remove(test_file_path());
+  std::filesystem::remove(path);
+  std::filesystem::remove(meta_path);
+}
+
+/// write content as gzip file consisting of num_members members (c.f. `cat a.gz b.gz`)
+static void write_gzip_file(const std::string& content, const std::string& path, size_t num_members,
+                            const char* mode = "ab") {
+  std::filesystem::remove(path);
+  size_t member_size = content.size() / num_members + 1;
+  for (size_t begin = 0; begin < content.size(); begin += member_size) {
+    gzFile file = gzopen(path.c_str(), mode);
+    ASSERT_NE(file, nullptr);
+    size_t size = std::min(member_size, content.size() - begin);
+    ASSERT_EQ(gzwrite(file, content.data() + begin, static_cast<unsigned>(size)), static_cast<int>(size));
+    gzclose(file);
+  }
+}
+
+TEST(GzipReader, builds_index_and_reads_in_parallel) {
+  std::string path = test_file_path() + ".gz";
+  std::string index_path = path + ".xsgzi";
+  // numbered lines: deflate blocks are small enough to get multiple checkpoints
+  std::string content;
+  for (size_t i = 0; content.size() < (1 << 21); ++i) {
+    content.append(std::to_string(i * 7919 % 100003)).append(" ").append(lines[i % 9]);
+  }
+  std::vector<uint64_t> expected = expected_line_offsets(content);
+
+  for (size_t num_members : {1, 3}) {
+    write_gzip_file(content, path, num_members);
+    std::filesystem::remove(index_path);
+    {
+      // first scan: sequential, builds the index
+      xs::GzipReader reader(path, 1 << 16);
+      ASSERT_FALSE(reader.has_index());
+      std::string read;
+      while (auto chunk = reader()) {
+        ASSERT_EQ(chunk->offset(), read.size());
+        ASSERT_EQ(chunk->back(), '\n');
+        read.append(chunk->data(), chunk->size());
+        reader.recycle(std::move(chunk.value()));
+      }
+      ASSERT_EQ(read, content);
+    }
+    auto index = xs::GzipIndex::load(index_path, std::filesystem::file_size(path));
+    ASSERT_TRUE(index.has_value());
+    ASSERT_EQ(index->uncompressed_size(), content.size());
+    ASSERT_GT(index->points().size(), 4);
+    {
+      // chunks read from the index cover the file exactly once
+      xs::GzipReader reader(path, 1 << 16);
+      ASSERT_TRUE(reader.has_index());
+      std::string read;
+      while (auto chunk = reader()) {
+        ASSERT_EQ(chunk->offset(), read.size());
+        read.append(chunk->data(), chunk->size());
+      }
+      ASSERT_EQ(read, content);
+    }
+    // parallel search using the index
+    xs::Searcher<xs::GzipReader<>, xs::LineIndexSearcher<xs::DataChunk>, xs::Result<xs::PartRes1<uint64_t>>,
+                 xs::PartRes1<uint64_t>, void, xs::DataChunk>
+        searcher(xs::GzipReader<>(path, 1 << 16), xs::LineIndexSearcher<xs::DataChunk>("ant"), 4);
+    auto& result = searcher.execute<xs::execute::blocking>().get();
+    std::vector<uint64_t> found;
+    for (const auto& partial_result : result.get()) {
+      found.insert(found.end(), partial_result.begin(), partial_result.end());
+    }
+    std::sort(found.begin(), found.end());
+    ASSERT_EQ(found, expected);
+  }
+
+  // an index of another file is ignored
+  std::ofstream(path, std::ios::binary | std::ios::app) << "x";
+  ASSERT_FALSE(xs::GzipReader(path, 1 << 16).has_index());
+  std::filesystem::remove(path);
+  std::filesystem::remove(index_path);
+}
+
+TEST(ParallelGzipReader, inflates_chunks_in_parallel) {
+  std::string path = test_file_path() + ".gz";
+  std::string content;
+  for (size_t i = 0; content.size() < (1 << 22); ++i) {
+    content.append(std::to_string(i * 7919 % 100003)).append(" ").append(lines[i % 9]);
+  }
+  std::vector<uint64_t> expected = expected_line_offsets(content);
+
+  // level 0: stored blocks only, no block boundaries are found and the first chunk inflates all data
+  for (auto [num_members, mode] : {std::tuple{1, "ab"}, {3, "ab9"}, {2, "ab0"}}) {
+    write_gzip_file(content, path, num_members, mode);
+    {
+      xs::ParallelGzipReader reader(path, 1 << 14);
+      ASSERT_GT(reader.num_chunks(), 8);
+      std::string read;
+      while (auto chunk = reader()) {
+        ASSERT_EQ(chunk->offset(), read.size());
+        ASSERT_EQ(chunk->back(), '\n');
+        read.append(chunk->data(), chunk->size());
+        reader.recycle(std::move(chunk.value()));
+      }
+      ASSERT_EQ(read, content);
+    }
+    xs::Searcher<xs::ParallelGzipReader<>, xs::LineIndexSearcher<xs::DataChunk>, xs::Result<xs::PartRes1<uint64_t>>,
+                 xs::PartRes1<uint64_t>, void, xs::DataChunk>
+        searcher(xs::ParallelGzipReader<>(path, 1 << 14), xs::LineIndexSearcher<xs::DataChunk>("ant"), 4);
+    auto& result = searcher.execute<xs::execute::blocking>().get();
+    std::vector<uint64_t> found;
+    for (const auto& partial_result : result.get()) {
+      found.insert(found.end(), partial_result.begin(), partial_result.end());
+    }
+    std::sort(found.begin(), found.end());
+    ASSERT_EQ(found, expected);
+  }
+
+  std::ofstream(path, std::ios::binary | std::ios::trunc) << "not gzip compressed";
+  ASSERT_THROW(xs::ParallelGzipReader<> reader(path), std::runtime_error);
+  std::filesystem::remove(path);
+}
+
+TEST(AutoReader, selects_reader_by_format) {
+  std::string content = write_test_file(test_file_path(), 2000);
+  std::vector<uint64_t> expected = expected_line_offsets(content);
+  auto search = [&expected](const std::string& path, const xs::AutoReaderOptions& options) {
+    xs::Searcher<xs::AutoReader<>, xs::LineIndexSearcher<xs::DataChunk>, xs::Result<xs::PartRes1<uint64_t>>,
+                 xs::PartRes1<uint64_t>, void, xs::DataChunk>
+        searcher(xs::AutoReader<>(path, options), xs::LineIndexSearcher<xs::DataChunk>("ant"), 4);
+    auto& result = searcher.execute<xs::execute::blocking>().get();
+    std::vector<uint64_t> found;
+    for (const auto& partial_result : result.get()) {
+      found.insert(found.end(), partial_result.begin(), partial_result.end());
+    }
+    std::sort(found.begin(), found.end());
+    ASSERT_EQ(found, expected);
+  };
+  xs::AutoReaderOptions options;
+  options.chunk_size = 1 << 14;
+
+  // plain text
+  ASSERT_EQ(xs::AutoReader(test_file_path()).format(), xs::FileFormat::PLAIN);
+  ASSERT_TRUE(xs::AutoReader(test_file_path()).parallel());
+  search(test_file_path(), options);
+
+  // gzip: speculative parallel inflation without index, sequential when building the index, parallel using it
+  std::string gz_path = test_file_path() + ".gz";
+  write_gzip_file(content, gz_path, 1);
+  std::filesystem::remove(gz_path + ".xsgzi");
+  ASSERT_EQ(xs::AutoReader(gz_path).format(), xs::FileFormat::GZIP);
+  ASSERT_TRUE(xs::AutoReader(gz_path, options).parallel());
+  search(gz_path, options);
+  ASSERT_FALSE(std::filesystem::exists(gz_path + ".xsgzi"));
+  options.build_gzip_index = true;
+  ASSERT_FALSE(xs::AutoReader(gz_path, options).parallel());
+  search(gz_path, options);
+  ASSERT_TRUE(std::filesystem::exists(gz_path + ".xsgzi"));
+  options.build_gzip_index = false;
+  ASSERT_TRUE(xs::AutoReader(gz_path, options).parallel());
+  search(gz_path, options);
+
+  // zstd and lz4 frames: sequential decompression
+  std::string zst_path = test_file_path() + ".zst";
+  std::string compressed(ZSTD_compressBound(content.size()), '\0');
+  compressed.resize(ZSTD_compress(compressed.data(), compressed.size(), content.data(), content.size(), 3));
+  std::ofstream(zst_path, std::ios::binary) << compressed;
+  ASSERT_EQ(xs::AutoReader(zst_path).format(), xs::FileFormat::ZSTD);
+  ASSERT_FALSE(xs::AutoReader(zst_path).parallel());
+  search(zst_path, options);
+  std::string lz4_path = test_file_path() + ".lz4";
+  compressed.resize(LZ4F_compressFrameBound(content.size(), nullptr));
+  compressed.resize(LZ4F_compressFrame(compressed.data(), compressed.size(), content.data(), content.size(), nullptr));
+  std::ofstream(lz4_path, std::ios::binary) << compressed;
+  ASSERT_EQ(xs::AutoReader(lz4_path).format(), xs::FileFormat::LZ4_FRAME);
+  search(lz4_path, options);
+
+  // preprocessed: chunks described by the meta file are decompressed in parallel
+  std::string xslz4_path = test_file_path() + ".xslz4";
+  write_compressed_file(content, xslz4_path, xslz4_path + ".meta", xs::CompressionType::LZ4, 8000,
+                        [](const char* data, size_t size) {
+                          std::string compressed(LZ4_compressBound(static_cast<int>(size)), '\0');
+                          compressed.resize(LZ4_compress_default(data, compressed.data(), static_cast<int>(size),
+                                                                 static_cast<int>(compressed.size())));
+                          return compressed;
+                        });
+  ASSERT_TRUE(xs::AutoReader(xslz4_path).parallel());
+  search(xslz4_path, options);
+
+  for (const auto& path : {test_file_path(), gz_path, gz_path + ".xsgzi", zst_path, lz4_path, xslz4_path,
+                           xslz4_path + ".meta"}) {
+    std::filesystem::remove(path);
+  }
+}
+
+/// append a tar member (ustar header, payload, padding) to archive
+static void append_tar_member(std::string& archive, const std::string& name, const std::string& payload,
+                              char type = '0', const std::string& prefix = "") {
+  char header[512] = {};
+  std::memcpy(header, name.data(), std::min<size_t>(name.size(), 100));
+  std::snprintf(header + 100, 8, "%07o", 0644);
+  std::snprintf(header + 124, 12, "%011llo", static_cast<unsigned long long>(payload.size()));
+  header[156] = type;
+  std::memcpy(header + 257, "ustar\0" "00", 8);
+  std::memcpy(header + 345, prefix.data(), std::min<size_t>(prefix.size(), 155));
+  std::memset(header + 148, ' ', 8);
+  unsigned checksum = 0;
+  for (char c : header) {
+    checksum += static_cast<unsigned char>(c);
+  }
+  std::snprintf(header + 148, 8, "%06o", checksum);
+  archive.append(header, sizeof(header));
+  archive.append(payload);
+  archive.append((512 - payload.size() % 512) % 512, '\0');
+}
+
+TEST(TarReader, searches_members_without_extraction) {
+  std::string tar_path = test_file_path() + ".tar";
+  std::string content = write_test_file(test_file_path(), 1);
+  std::string long_name = "docs/" + std::string(120, 'x') + ".txt";
+  std::string long_line = std::string(10000, 'y') + " ant\n";
+  std::vector<std::pair<std::string, std::string>> members{{"docs/small.txt", content},
+                                                           {"empty.txt", ""},
+                                                           {long_name, write_test_file(test_file_path(), 200)},
+                                                           {"pax/name.txt", content + "no newline ant"},
+                                                           {"deep/dir/file.txt", long_line + content}};
+  std::string archive;
+  append_tar_member(archive, "docs/", "", '5');
+  append_tar_member(archive, members[0].first, members[0].second);
+  append_tar_member(archive, members[1].first, members[1].second);
+  append_tar_member(archive, "././@LongLink", long_name + '\0', 'L');
+  append_tar_member(archive, long_name.substr(0, 100), members[2].second);
+  std::string record = "path=" + members[3].first + "\n";
+  record = std::to_string(record.size() + 3) + " " + record;
+  append_tar_member(archive, "PaxHeader", record, 'x');
+  append_tar_member(archive, "ignored", members[3].second);
+  append_tar_member(archive, "file.txt", members[4].second, '0', "deep/dir");
+  archive.append(1024, '\0');
+  std::ofstream(tar_path, std::ios::binary) << archive;
+
+  std::vector<std::tuple<std::string, uint64_t>> expected;
+  for (const auto& [name, payload] : members) {
+    for (uint64_t offset : expected_line_offsets(payload)) {
+      expected.emplace_back(name, offset);
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+
+  auto search = [&](const std::string& path) {
+    xs::TarReader reader(path, 4096);
+    auto member_paths = reader.members();
+    using searcher_t = xs::MultiFileSearcher<xs::LineIndexSearcher<xs::DataView>>;
+    xs::Searcher<xs::TarReader<>, searcher_t, xs::Result<searcher_t::result_type>, searcher_t::result_type, void,
+                 xs::MultiFileChunk>
+        searcher(std::move(reader), searcher_t(xs::LineIndexSearcher<xs::DataView>("ant")), 4);
+    auto& result = searcher.execute<xs::execute::blocking>().get();
+    std::vector<std::string> regular_files;
+    for (const auto& member : members) {
+      regular_files.push_back(member.first);
+    }
+    ASSERT_EQ(*member_paths, regular_files);
+    std::vector<std::tuple<std::string, uint64_t>> found;
+    for (const auto& partial_result : result.get()) {
+      for (const auto& [member_id, offset] : partial_result) {
+        found.emplace_back((*member_paths)[member_id], offset);
+      }
+    }
+    std::sort(found.begin(), found.end());
+    ASSERT_EQ(found, expected);
+  };
+  search(tar_path);
+  std::string tgz_path = tar_path + ".gz";
+  write_gzip_file(archive, tgz_path, 2);
+  search(tgz_path);
+
+  // every payload byte is read exactly once, split at line boundaries
+  xs::TarReader reader(tar_path, 1000);
+  std::vector<std::string> payloads(members.size());
+  while (auto chunk = reader()) {
+    for (const auto& segment : chunk->segments()) {
+      ASSERT_EQ(segment.file_offset, payloads[segment.file_id].size());
+      payloads[segment.file_id].append(chunk->data() + segment.begin, segment.size);
+      ASSERT_TRUE(payloads[segment.file_id].back() == '\n' ||
+                  payloads[segment.file_id].size() == members[segment.file_id].second.size());
+    }
+  }
+  for (size_t i = 0; i < members.size(); ++i) {
+    ASSERT_EQ(payloads[i], members[i].second);
+  }
+
+  xs::TarReader not_a_tar(test_file_path());
+  ASSERT_THROW(not_a_tar(), std::runtime_error);
+  for (const auto& path : {test_file_path(), tar_path, tgz_path}) {
+    std::filesystem::remove(path);
+  }
+}
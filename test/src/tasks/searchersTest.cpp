@@ -0,0 +1,417 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <gtest/gtest.h>
+#include <xsearch/Searcher.h>
+#include <xsearch/tasks/readers.h>
+#include <xsearch/tasks/searchers.h>
+#include <xsearch/utils/Synchronized.h>
+#include <xsearch/utils/ThreadPool.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+#include "test_utils.h"
+
+static std::string test_file_path() {
+  return (std::filesystem::temp_directory_path() / "xs_searchersTest.txt").string();
+}
+
+TEST(Searcher, pipelined_reader_and_search_threads) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 1000);
+
+  std::vector<uint64_t> expected = expected_line_offsets(content);
+  auto collect = [](const auto& result) {
+    std::vector<uint64_t> found;
+    for (const auto& partial_result : result.get()) {
+      found.insert(found.end(), partial_result.begin(), partial_result.end());
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+  };
+
+  // concurrent reader: several reader threads, queue smaller than the number of chunks
+  {
+    xs::Searcher<xs::PReadFileReader<>, xs::LineIndexSearcher<xs::DataChunk>, xs::Result<xs::PartRes1<uint64_t>>,
+                 xs::PartRes1<uint64_t>, void, xs::DataChunk>
+        searcher(xs::PReadFileReader<>(path, 4096, true), xs::LineIndexSearcher<xs::DataChunk>("ant"), 4,
+                 xs::Pipeline{3, 4});
+    ASSERT_EQ(collect(searcher.execute<xs::execute::blocking>().get()), expected);
+  }
+  // sequential reader feeding more search threads than queue slots
+  {
+    xs::Searcher<xs::FileReader<xs::DataChunk>, xs::LineIndexSearcher<xs::DataChunk>,
+                 xs::Result<xs::PartRes1<uint64_t>>, xs::PartRes1<uint64_t>, void, xs::DataChunk>
+        searcher(xs::FileReader<xs::DataChunk>(path, 4096, true), xs::LineIndexSearcher<xs::DataChunk>("ant"), 6,
+                 xs::Pipeline{2, 2});
+    ASSERT_EQ(collect(searcher.execute<xs::execute::blocking>().get()), expected);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(Searcher, concurrent_searches_share_thread_pool) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 1000);
+
+  std::vector<uint64_t> expected = expected_line_offsets(content);
+
+  using searcher_t = xs::Searcher<xs::PReadFileReader<>, xs::LineIndexSearcher<xs::DataChunk>,
+                                  xs::Result<xs::PartRes1<uint64_t>>, xs::PartRes1<uint64_t>, void, xs::DataChunk>;
+  xs::utils::ThreadPool pool(3);
+  std::vector<std::unique_ptr<searcher_t>> searchers;
+  for (int i = 0; i < 8; ++i) {
+    searchers.push_back(std::make_unique<searcher_t>(xs::PReadFileReader<>(path, 4096, true),
+                                                     xs::LineIndexSearcher<xs::DataChunk>("ant"), pool, 1 + i % 4));
+  }
+  std::vector<std::future<xs::Result<xs::PartRes1<uint64_t>>&>> futures;
+  for (auto& searcher : searchers) {
+    futures.push_back(searcher->execute<xs::execute::live>());
+  }
+  for (size_t i = 0; i < searchers.size(); ++i) {
+    searchers[i]->join();
+    std::vector<uint64_t> found;
+    for (const auto& partial_result : futures[i].get().get()) {
+      found.insert(found.end(), partial_result.begin(), partial_result.end());
+    }
+    std::sort(found.begin(), found.end());
+    ASSERT_EQ(found, expected);
+  }
+  std::filesystem::remove(path);
+}
+
+/// PReadFileReader appending id to a common log for every chunk it returns
+struct LoggingReader {
+  static constexpr bool concurrent_access = true;
+
+  std::optional<xs::DataChunk> operator()() {
+    auto chunk = reader();
+    if (chunk) {
+      log->wlock()->push_back(id);
+    }
+    return chunk;
+  }
+
+  void recycle(xs::DataChunk&& chunk) { reader.recycle(std::move(chunk)); }
+
+  xs::PReadFileReader<> reader;
+  int id;
+  std::shared_ptr<xs::Synchronized<std::vector<int>>> log;
+};
+
+TEST(Searcher, searches_on_one_worker_take_turns) {
+  std::string path = test_file_path();
+  write_test_file(path, 200);
+
+  using searcher_t = xs::Searcher<LoggingReader, xs::LineIndexSearcher<xs::DataChunk>,
+                                  xs::Result<xs::PartRes1<uint64_t>>, xs::PartRes1<uint64_t>, void, xs::DataChunk>;
+  auto log = std::make_shared<xs::Synchronized<std::vector<int>>>();
+  xs::utils::ThreadPool pool(1);
+  // keep the worker busy until both searches were started
+  std::promise<void> started;
+  pool.submit([future = started.get_future().share()]() { future.wait(); });
+  std::vector<std::unique_ptr<searcher_t>> searchers;
+  for (int id : {0, 1}) {
+    searchers.push_back(std::make_unique<searcher_t>(LoggingReader{xs::PReadFileReader<>(path, 1024, true), id, log},
+                                                     xs::LineIndexSearcher<xs::DataChunk>("ant"), pool));
+    searchers.back()->execute<xs::execute::live>();
+  }
+  started.set_value();
+  for (auto& searcher : searchers) {
+    searcher->join();
+  }
+  std::vector<int> chunks = *log->wlock();
+  ASSERT_GT(chunks.size(), 100);
+  // both searches read the same number of chunks, alternately
+  for (size_t i = 1; i < chunks.size(); ++i) {
+    ASSERT_NE(chunks[i], chunks[i - 1]) << "chunk " << i;
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(Searcher, ordered_results_without_sorting) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 500);
+  // chunks within this line are empty
+  std::ofstream(path, std::ios::binary | std::ios::app) << std::string(20000, 'x') << " ant\n";
+  content.append(20000, 'x').append(" ant\n");
+  std::string tail = content.substr(0, content.find('\n', 10000) + 1);
+  std::ofstream(path, std::ios::binary | std::ios::app) << tail;
+  content.append(tail);
+
+  std::vector<uint64_t> expected = expected_line_offsets(content);
+
+  using result_t = xs::OrderedResult<xs::PartRes1<uint64_t>>;
+  using searcher_t = xs::Searcher<xs::PReadFileReader<>, xs::LineIndexSearcher<xs::DataChunk>, result_t,
+                                  xs::PartRes1<uint64_t>, void, xs::DataChunk>;
+  // results are streamed in file order while the search is running
+  {
+    searcher_t searcher(xs::PReadFileReader<>(path, 1024, true), xs::LineIndexSearcher<xs::DataChunk>("ant"), 4);
+    auto& result = searcher.execute<xs::execute::live>().get();
+    std::vector<uint64_t> found;
+    for (const auto& partial_result : result) {
+      found.insert(found.end(), partial_result.begin(), partial_result.end());
+    }
+    ASSERT_EQ(found, expected);
+    ASSERT_EQ(result.num_pending(), 0);
+  }
+  // pipelined: the window exceeds the number of chunks in flight
+  {
+    searcher_t searcher(xs::PReadFileReader<>(path, 1024, true), xs::LineIndexSearcher<xs::DataChunk>("ant"), 4,
+                        xs::Pipeline{2, 8});
+    std::vector<uint64_t> found;
+    for (const auto& partial_result : searcher.execute<xs::execute::blocking>().get().get()) {
+      found.insert(found.end(), partial_result.begin(), partial_result.end());
+    }
+    ASSERT_EQ(found, expected);
+  }
+  std::filesystem::remove(path);
+}
+
+/// PReadFileReader counting the chunks it returned, optionally requesting stop on stop_source after stop_after chunks
+struct CountingReader {
+  static constexpr bool concurrent_access = true;
+
+  std::optional<xs::DataChunk> operator()() {
+    auto chunk = reader();
+    if (chunk && num_chunks->fetch_add(1) + 1 == stop_after) {
+      stop_source.request_stop();
+    }
+    return chunk;
+  }
+
+  void recycle(xs::DataChunk&& chunk) { reader.recycle(std::move(chunk)); }
+
+  xs::PReadFileReader<> reader;
+  std::shared_ptr<std::atomic<size_t>> num_chunks;
+  size_t stop_after = 0;
+  std::stop_source stop_source = std::stop_source(std::nostopstate);
+};
+
+TEST(Searcher, lazy_execution_reads_on_demand) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 2000);
+  std::vector<uint64_t> expected = expected_line_offsets(content);
+
+  using result_t = xs::Result<xs::PartRes1<uint64_t>>;
+  using searcher_t = xs::Searcher<CountingReader, xs::LineIndexSearcher<xs::DataChunk>, result_t,
+                                  xs::PartRes1<uint64_t>, void, xs::DataChunk>;
+  auto num_chunks = std::make_shared<std::atomic<size_t>>(0);
+  auto make_searcher = [&](auto&&... args) {
+    num_chunks->store(0);
+    return std::make_unique<searcher_t>(CountingReader{xs::PReadFileReader<>(path, 1024, true), num_chunks},
+                                        xs::LineIndexSearcher<xs::DataChunk>("ant"), args...);
+  };
+  xs::utils::ThreadPool pool(3);
+  for (bool use_pool : {false, true}) {
+    // first 20 matches: every chunk holds at least one match, the remaining chunks are never read
+    {
+      auto searcher = use_pool ? make_searcher(pool) : make_searcher(2);
+      std::vector<uint64_t> found;
+      for (const auto& partial_result : searcher->execute<xs::execute::lazy>(4)) {
+        found.insert(found.end(), partial_result.begin(), partial_result.end());
+        if (found.size() >= 20) {
+          break;
+        }
+      }
+      searcher.reset();
+      ASSERT_GE(found.size(), 20);
+      ASSERT_TRUE(std::equal(found.begin(), found.end(), expected.begin()));
+      ASSERT_LE(num_chunks->load(), 20 + 4);
+    }
+    // iterating all partial results searches the whole file in order
+    {
+      auto searcher = use_pool ? make_searcher(pool) : make_searcher(2);
+      std::vector<uint64_t> found;
+      for (const auto& partial_result : searcher->execute<xs::execute::lazy>()) {
+        found.insert(found.end(), partial_result.begin(), partial_result.end());
+      }
+      ASSERT_EQ(found, expected);
+      ASSERT_GT(num_chunks->load(), 20 + 4);
+    }
+  }
+  std::filesystem::remove(path);
+}
+
+/// PReadFileReader numbering its chunks 1, 2, 4, 5, ... (not starting at 0, sequence number 3 is skipped)
+struct GappedReader {
+  static constexpr bool concurrent_access = true;
+
+  std::optional<xs::DataChunk> operator()() {
+    auto chunk = reader();
+    if (chunk) {
+      uint64_t sequence_number = chunk->sequence_number() + 1;
+      chunk->set_sequence_number(sequence_number < 3 ? sequence_number : sequence_number + 1);
+    }
+    return chunk;
+  }
+
+  void recycle(xs::DataChunk&& chunk) { reader.recycle(std::move(chunk)); }
+
+  xs::PReadFileReader<> reader;
+};
+
+TEST(Searcher, lazy_execution_with_gapped_sequence_numbers) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 200);
+  std::vector<uint64_t> expected = expected_line_offsets(content);
+
+  using searcher_t = xs::Searcher<GappedReader, xs::LineIndexSearcher<xs::DataChunk>,
+                                  xs::Result<xs::PartRes1<uint64_t>>, xs::PartRes1<uint64_t>, void, xs::DataChunk>;
+  xs::utils::ThreadPool pool(2);
+  for (bool use_pool : {false, true}) {
+    for (size_t lookahead : {1, 2, 8}) {
+      GappedReader reader{xs::PReadFileReader<>(path, 1024, true)};
+      xs::LineIndexSearcher<xs::DataChunk> line_searcher("ant");
+      auto searcher = use_pool ? std::make_unique<searcher_t>(std::move(reader), std::move(line_searcher), pool)
+                               : std::make_unique<searcher_t>(std::move(reader), std::move(line_searcher), 2);
+      std::vector<uint64_t> found;
+      for (const auto& partial_result : searcher->execute<xs::execute::lazy>(lookahead)) {
+        found.insert(found.end(), partial_result.begin(), partial_result.end());
+      }
+      ASSERT_EQ(found, expected);
+    }
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(Searcher, max_count_and_cancellation) {
+  std::string path = test_file_path();
+  std::string content = write_test_file(path, 2000);
+  std::vector<uint64_t> expected = expected_line_offsets(content);
+  // about 1200 chunks: stopping searches have to leave most of them unread
+  const size_t max_chunks_read = 100;
+
+  using result_t = xs::OrderedResult<xs::PartRes1<uint64_t>>;
+  using searcher_t = xs::Searcher<CountingReader, xs::LineIndexSearcher<xs::DataChunk>, result_t,
+                                  xs::PartRes1<uint64_t>, void, xs::DataChunk>;
+  auto num_chunks = std::make_shared<std::atomic<size_t>>(0);
+  auto make_searcher = [&](auto&&... args) {
+    num_chunks->store(0);
+    return std::make_unique<searcher_t>(CountingReader{xs::PReadFileReader<>(path, 1024, true), num_chunks},
+                                        xs::LineIndexSearcher<xs::DataChunk>("ant"), args...);
+  };
+  auto collect = [](result_t& result) {
+    std::vector<uint64_t> found;
+    for (const auto& partial_result : result) {
+      found.insert(found.end(), partial_result.begin(), partial_result.end());
+    }
+    return found;
+  };
+
+  xs::utils::ThreadPool pool(3);
+  for (uint64_t max_count : {1, 50}) {
+    std::vector<std::unique_ptr<searcher_t>> searchers;
+    searchers.push_back(make_searcher(4));
+    searchers.push_back(make_searcher(2, xs::Pipeline{1, 8}));
+    searchers.push_back(make_searcher(pool));
+    for (auto& searcher : searchers) {
+      num_chunks->store(0);
+      searcher->set_max_count(max_count);
+      auto found = collect(searcher->execute<xs::execute::blocking>().get());
+      ASSERT_GE(found.size(), max_count);
+      ASSERT_TRUE(std::includes(expected.begin(), expected.end(), found.begin(), found.end()));
+      ASSERT_TRUE(searcher->budget_exhausted());
+      ASSERT_LE(num_chunks->load(), max_chunks_read);
+    }
+  }
+  // lazy: the consumer gets all results found within the budget
+  {
+    auto searcher = make_searcher(2);
+    searcher->set_max_count(30);
+    std::vector<uint64_t> found;
+    for (const auto& partial_result : searcher->execute<xs::execute::lazy>()) {
+      found.insert(found.end(), partial_result.begin(), partial_result.end());
+    }
+    ASSERT_GE(found.size(), 30);
+    ASSERT_TRUE(std::includes(expected.begin(), expected.end(), found.begin(), found.end()));
+    ASSERT_LE(num_chunks->load(), max_chunks_read);
+  }
+  // cancelled before the search starts: nothing is read
+  {
+    std::stop_source stop_source;
+    stop_source.request_stop();
+    auto searcher = make_searcher(4);
+    searcher->set_stop_token(stop_source.get_token());
+    ASSERT_TRUE(collect(searcher->execute<xs::execute::blocking>().get()).empty());
+    ASSERT_TRUE(searcher->cancelled());
+    ASSERT_EQ(num_chunks->load(), 0);
+  }
+  // cancelled while running (here: by the reader after 10 chunks): the result is closed early
+  for (bool use_pool : {false, true}) {
+    std::stop_source stop_source;
+    num_chunks->store(0);
+    CountingReader reader{xs::PReadFileReader<>(path, 1024, true), num_chunks, 10, stop_source};
+    xs::LineIndexSearcher<xs::DataChunk> line_searcher("ant");
+    auto searcher = use_pool ? std::make_unique<searcher_t>(std::move(reader), std::move(line_searcher), pool)
+                             : std::make_unique<searcher_t>(std::move(reader), std::move(line_searcher), 4);
+    searcher->set_stop_token(stop_source.get_token());
+    auto found = collect(searcher->execute<xs::execute::live>().get());
+    searcher->join();
+    ASSERT_TRUE(searcher->cancelled());
+    ASSERT_TRUE(std::includes(expected.begin(), expected.end(), found.begin(), found.end()));
+    ASSERT_LE(num_chunks->load(), 10 + 4);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(Searcher, reader_errors_are_rethrown) {
+  std::string path = test_file_path() + ".gz";
+  std::string content = write_test_file(test_file_path(), 4000);
+  gzFile file = gzopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(gzwrite(file, content.data(), static_cast<unsigned>(content.size())), static_cast<int>(content.size()));
+  gzclose(file);
+  // truncated: inflating the second half fails
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+
+  using result_t = xs::Result<xs::PartRes1<uint64_t>>;
+  using gzip_searcher_t = xs::Searcher<xs::GzipReader<>, xs::LineIndexSearcher<xs::DataChunk>, result_t,
+                                       xs::PartRes1<uint64_t>, void, xs::DataChunk>;
+  using parallel_searcher_t = xs::Searcher<xs::ParallelGzipReader<>, xs::LineIndexSearcher<xs::DataChunk>,
+                                           xs::OrderedResult<xs::PartRes1<uint64_t>>, xs::PartRes1<uint64_t>, void,
+                                           xs::DataChunk>;
+  auto gzip_reader = [&]() { return xs::GzipReader<>(path, 16384, "", false); };
+  xs::utils::ThreadPool pool(3);
+  {
+    gzip_searcher_t searcher(gzip_reader(), xs::LineIndexSearcher<xs::DataChunk>("ant"), 4);
+    ASSERT_THROW(searcher.execute<xs::execute::blocking>(), std::runtime_error);
+    ASSERT_TRUE(searcher.cancelled());
+  }
+  {
+    gzip_searcher_t searcher(gzip_reader(), xs::LineIndexSearcher<xs::DataChunk>("ant"), 2, xs::Pipeline{1, 4});
+    auto future = searcher.execute<xs::execute::async>();
+    ASSERT_THROW(future.get(), std::runtime_error);
+  }
+  {
+    gzip_searcher_t searcher(gzip_reader(), xs::LineIndexSearcher<xs::DataChunk>("ant"), pool);
+    auto& result = searcher.execute<xs::execute::live>().get();
+    // the result is closed once the error occurred
+    for ([[maybe_unused]] const auto& partial_result : result) {
+    }
+    ASSERT_THROW(searcher.join(), std::runtime_error);
+  }
+  {
+    gzip_searcher_t searcher(gzip_reader(), xs::LineIndexSearcher<xs::DataChunk>("ant"), 2);
+    auto consume = [&searcher]() {
+      for ([[maybe_unused]] const auto& partial_result : searcher.execute<xs::execute::lazy>()) {
+      }
+    };
+    ASSERT_THROW(consume(), std::runtime_error);
+  }
+  {
+    parallel_searcher_t searcher(xs::ParallelGzipReader<>(path, 16384), xs::LineIndexSearcher<xs::DataChunk>("ant"),
+                                 4);
+    ASSERT_THROW(searcher.execute<xs::execute::blocking>(), std::runtime_error);
+  }
+  std::filesystem::remove(path);
+  std::filesystem::remove(test_file_path());
+}
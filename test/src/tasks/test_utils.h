@@ -0,0 +1,51 @@
+/**
+ * Copyright 2023, Leon Freist (https://github.com/lfreist)
+ * Author: Leon Freist <freist.leon@gmail.com>
+ *
+ * This file is part of x-search.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+inline const std::string lines[] = {
+    "Liant reindorsing two-time zippering chromolithography rainbowweed\n",
+    "Cacatua bunking cooptions zinckenite Polygala\n",
+    "smooth-bellied chirognostic inkos BVM antigraphy pagne bicorne\n",
+    "complementizer commorant ever-endingly sheikhly\n",
+    "glam predamaged objectionability evil-looking quaquaversal\n",
+    "composite halter-wise mosasaur Whelan coleopterist grass-grown Helladic\n",
+    "DNB nondeliriousness arpents uncasing\n",
+    "predepletion delator unnaive sucken solid-gold brassards tutorials\n",
+    "refrangible terebras autobiographal mid-breast ant\n"};
+
+/// write a test file consisting of num_repetitions times the lines above and return its content
+inline std::string write_test_file(const std::string& path, size_t num_repetitions) {
+  std::string content;
+  for (size_t i = 0; i < num_repetitions; ++i) {
+    for (const auto& line : lines) {
+      content.append(line);
+    }
+  }
+  std::ofstream out(path, std::ios::binary);
+  out.write(content.data(), static_cast<std::streamsize>(content.size()));
+  return content;
+}
+
+/// begin offsets of the lines of content that contain pattern
+inline std::vector<uint64_t> expected_line_offsets(const std::string& content, const std::string& pattern = "ant") {
+  std::vector<uint64_t> offsets;
+  for (size_t line_begin = 0; line_begin < content.size();) {
+    size_t line_end = std::min(content.find('\n', line_begin), content.size());
+    if (content.substr(line_begin, line_end - line_begin).find(pattern) != std::string::npos) {
+      offsets.push_back(line_begin);
+    }
+    line_begin = line_end + 1;
+  }
+  return offsets;
+}
@@ -0,0 +1,83 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <gtest/gtest.h>
+#include <xsearch/utils/ChunkSizeTuner.h>
+
+#include <chrono>
+#include <functional>
+
+using xs::utils::ChunkSizeTuner;
+using std::chrono::nanoseconds;
+
+/**
+ * Feed the tuner with chunks whose read and search times are given by the models until it converges (or max_chunks
+ *  chunks were processed).
+ */
+static void simulate(ChunkSizeTuner& tuner, const std::function<nanoseconds(size_t)>& read_time,
+                     const std::function<nanoseconds(size_t)>& search_time, size_t max_chunks = 10000) {
+  for (size_t i = 0; i < max_chunks && !tuner.converged(); ++i) {
+    size_t chunk_size = tuner.chunk_size();
+    tuner.record_read(chunk_size, read_time(chunk_size));
+    tuner.record_search(chunk_size, search_time(chunk_size), chunk_size / 1000);
+  }
+}
+
+TEST(ChunkSizeTuner, converges_to_best_chunk_size) {
+  // large per read overhead, searching chunks larger than 1 MiB gets slow (cache misses)
+  auto read_time = [](size_t size) { return nanoseconds(200000 + size / 10); };
+  auto search_time = [](size_t size) { return nanoseconds(size <= (1 << 20) ? size : 4 * size); };
+
+  ChunkSizeTuner tuner(1 << 16, 4);
+  simulate(tuner, read_time, search_time);
+  ASSERT_TRUE(tuner.converged());
+  ASSERT_EQ(tuner.chunk_size(), 1 << 20);
+
+  auto history = tuner.history();
+  // 64 KiB, 128 KiB, ..., 2 MiB and the step back down to 512 KiB
+  ASSERT_EQ(history.size(), 7);
+  ASSERT_EQ(history.front().chunk_size, 1 << 16);
+  ASSERT_EQ(history.back().chunk_size, 1 << 19);
+  for (const auto& epoch : history) {
+    ASSERT_EQ(epoch.num_chunks, 16);
+    ASSERT_DOUBLE_EQ(epoch.bytes, static_cast<double>(epoch.chunk_size));
+    ASSERT_DOUBLE_EQ(epoch.num_results, static_cast<double>(epoch.chunk_size / 1000));
+    ASSERT_GT(epoch.throughput, 0);
+  }
+}
+
+TEST(ChunkSizeTuner, shrinks_if_workers_are_the_bottleneck) {
+  // reading is cheap, searching gets slower per byte the larger the chunk is
+  auto read_time = [](size_t size) { return nanoseconds(2000 + size / 100); };
+  auto search_time = [](size_t size) { return nanoseconds(size + size * size / (1 << 18)); };
+
+  ChunkSizeTuner tuner(1 << 20, 8, 1 << 12);
+  simulate(tuner, read_time, search_time);
+  ASSERT_TRUE(tuner.converged());
+  ASSERT_EQ(tuner.chunk_size(), 1 << 15);
+  ASSERT_EQ(tuner.history().front().chunk_size, 1 << 20);
+  ASSERT_EQ(tuner.history()[1].chunk_size, 1 << 19);
+}
+
+TEST(ChunkSizeTuner, respects_bounds) {
+  ChunkSizeTuner tuner(1 << 30, 4, 1 << 16, 1 << 18);
+  ASSERT_EQ(tuner.chunk_size(), 1 << 18);
+
+  ChunkSizeTuner fixed(1 << 20, 4, 1 << 20, 1 << 20);
+  simulate(
+      fixed, [](size_t size) { return nanoseconds(size); }, [](size_t size) { return nanoseconds(size); });
+  ASSERT_TRUE(fixed.converged());
+  ASSERT_EQ(fixed.chunk_size(), 1 << 20);
+  ASSERT_EQ(fixed.history().size(), 1);
+}
+
+TEST(ChunkSizeTuner, ignores_chunks_of_previous_sizes) {
+  ChunkSizeTuner tuner(1 << 16, 4, 1 << 16, 1 << 24, 1);
+  tuner.record_read(1 << 16, nanoseconds(1000000));
+  tuner.record_search(1 << 16, nanoseconds(1), 0);
+  ASSERT_EQ(tuner.chunk_size(), 1 << 17);
+  // still in flight when the chunk size was changed
+  tuner.record_read(1 << 10, nanoseconds(1));
+  tuner.record_search(1 << 10, nanoseconds(1), 0);
+  ASSERT_EQ(tuner.history().size(), 1);
+}
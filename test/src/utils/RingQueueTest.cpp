@@ -0,0 +1,69 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <gtest/gtest.h>
+#include <xsearch/utils/RingQueue.h>
+
+#include <optional>
+#include <thread>
+#include <vector>
+
+using xs::utils::RingQueue;
+
+TEST(RingQueue, fifo_single_thread) {
+  RingQueue<int> queue(4);
+  for (int lap = 0; lap < 3; ++lap) {
+    for (int i = 0; i < 4; ++i) {
+      queue.push(lap * 4 + i);
+    }
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_EQ(queue.pop(), lap * 4 + i);
+    }
+  }
+}
+
+TEST(RingQueue, every_value_is_popped_exactly_once) {
+  constexpr int num_producers = 4;
+  constexpr int num_consumers = 5;
+  constexpr int num_values = 20000;
+  RingQueue<std::optional<int>> queue(8);
+  std::vector<std::vector<int>> popped(num_consumers);
+  std::vector<std::thread> threads;
+  for (int c = 0; c < num_consumers; ++c) {
+    threads.emplace_back([&queue, &popped, c]() {
+      while (auto value = queue.pop()) {
+        popped[c].push_back(*value);
+      }
+    });
+  }
+  std::vector<std::thread> producers;
+  for (int p = 0; p < num_producers; ++p) {
+    producers.emplace_back([&queue, p]() {
+      for (int value = p; value < num_values; value += num_producers) {
+        queue.push(value);
+      }
+    });
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+  for (int c = 0; c < num_consumers; ++c) {
+    queue.push(std::nullopt);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  std::vector<int> count(num_values, 0);
+  for (const auto& values : popped) {
+    // values of one producer are popped in the order they were pushed
+    std::vector<int> last(num_producers, -1);
+    for (int value : values) {
+      ASSERT_GT(value, last[value % num_producers]);
+      last[value % num_producers] = value;
+      count[value]++;
+    }
+  }
+  for (int c : count) {
+    ASSERT_EQ(c, 1);
+  }
+}
@@ -0,0 +1,71 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <gtest/gtest.h>
+#include <xsearch/utils/ThreadPool.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using xs::utils::ThreadPool;
+
+TEST(ThreadPool, runs_all_tasks_before_destruction) {
+  std::atomic<int> count = 0;
+  {
+    ThreadPool pool(3);
+    ASSERT_EQ(pool.num_workers(), 3);
+    for (int i = 0; i < 1000; ++i) {
+      pool.submit([&count]() { count++; });
+    }
+  }
+  ASSERT_EQ(count.load(), 1000);
+}
+
+TEST(ThreadPool, tasks_submitted_by_tasks) {
+  std::atomic<int> count = 0;
+  std::function<void(int)> spawn;
+  {
+    ThreadPool pool(4);
+    // binary tree of tasks: 2^11 - 1 tasks in total
+    spawn = [&](int depth) {
+      count++;
+      if (depth > 0) {
+        pool.submit([&spawn, depth]() { spawn(depth - 1); });
+        pool.submit([&spawn, depth]() { spawn(depth - 1); });
+      }
+    };
+    pool.submit([&spawn]() { spawn(10); });
+    while (count.load() < (1 << 11) - 1) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  ASSERT_EQ(count.load(), (1 << 11) - 1);
+}
+
+TEST(ThreadPool, idle_workers_steal_tasks) {
+  std::mutex mutex;
+  std::set<std::thread::id> workers;
+  std::atomic<int> done = 0;
+  ThreadPool pool(4);
+  // all tasks are pushed to the deque of the worker running the first task
+  pool.submit([&]() {
+    for (int i = 0; i < 64; ++i) {
+      pool.submit([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        {
+          std::unique_lock lock(mutex);
+          workers.insert(std::this_thread::get_id());
+        }
+        done++;
+      });
+    }
+  });
+  while (done.load() < 64) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_GT(workers.size(), 1);
+}
@@ -0,0 +1,108 @@
+// Copyright 2023, Leon Freist
+// Author: Leon Freist <freist@informatik.uni-freiburg.de>
+
+#include <xsearch/Preprocessor.h>
+
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <string>
+
+static void print_usage() {
+  std::cout << "Splits a file into newline aligned chunks, compresses them in parallel and writes the compressed file\n"
+               "and its meta file (*.meta).\n";
+  std::cout << "Usage:\n";
+  std::cout << " ./xspp <path/to/input/file|-> [options]\n";
+  std::cout << "Options:\n";
+  std::cout << " -o <path>       output file (default: <input>.xslz4|.xslz4hc|.xszst|.xsmix|.xs)\n";
+  std::cout << " -m <path>       meta file (default: <output>.meta)\n";
+  std::cout << " -a <algorithm>  lz4 (default), lz4hc, zstd, adaptive (raw, lz4 or zstd per chunk) or none\n";
+  std::cout << " -l <level>      compression level (lz4hc, zstd, adaptive)\n";
+  std::cout << " -s <bytes>      chunk size (default: 16 MiB)\n";
+  std::cout << " -j <threads>    number of compression threads (default: all cores)\n";
+  std::cout << " -d <bytes>      distance of line mapping points (default: 500)\n";
+  std::cout << " -D <bytes>      train a dictionary of this size and compress all chunks using it (zstd, adaptive)\n";
+  std::cout << " -c <lz4>,<zstd> decode costs in bytes per decompressed byte (adaptive, default: 0.1,0.25)" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2 || (argc % 2) != 0) {
+    print_usage();
+    return 1;
+  }
+
+  std::string input_path(argv[1]);
+  std::string output_path;
+  std::string meta_file_path;
+  xs::PreprocessOptions options;
+
+  try {
+    for (int i = 2; i < argc; i += 2) {
+      std::string option(argv[i]);
+      std::string value(argv[i + 1]);
+      if (option == "-o") {
+        output_path = value;
+      } else if (option == "-m") {
+        meta_file_path = value;
+      } else if (option == "-a") {
+        if (value == "lz4") {
+          options.algorithm = xs::PreprocessOptions::Algorithm::LZ4;
+        } else if (value == "lz4hc") {
+          options.algorithm = xs::PreprocessOptions::Algorithm::LZ4_HC;
+        } else if (value == "zstd") {
+          options.algorithm = xs::PreprocessOptions::Algorithm::ZSTD;
+        } else if (value == "adaptive") {
+          options.algorithm = xs::PreprocessOptions::Algorithm::ADAPTIVE;
+        } else if (value == "none") {
+          options.algorithm = xs::PreprocessOptions::Algorithm::NONE;
+        } else {
+          std::cerr << "Unknown algorithm '" << value << "'" << std::endl;
+          return 1;
+        }
+      } else if (option == "-l") {
+        options.level = std::stoi(value);
+      } else if (option == "-s") {
+        options.chunk_size = std::stoull(value);
+      } else if (option == "-j") {
+        options.num_threads = std::stoull(value);
+      } else if (option == "-d") {
+        options.mapping_distance = std::stoull(value);
+      } else if (option == "-D") {
+        options.dictionary_size = std::stoull(value);
+      } else if (option == "-c") {
+        size_t separator = value.find(',');
+        options.lz4_decode_cost = std::stod(value.substr(0, separator));
+        options.zstd_decode_cost = std::stod(value.substr(separator + 1));
+      } else {
+        print_usage();
+        return 1;
+      }
+    }
+  } catch (const std::exception&) {
+    print_usage();
+    return 1;
+  }
+
+  if (output_path.empty()) {
+    if (input_path == "-") {
+      std::cerr << "An output file (-o) is required when reading from stdin" << std::endl;
+      return 1;
+    }
+    output_path = input_path + xs::file_extension(options.algorithm);
+  }
+  if (meta_file_path.empty()) {
+    meta_file_path = output_path + ".meta";
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  try {
+    xs::preprocess(input_path, output_path, meta_file_path, options);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  std::cout << "Wrote " << output_path << " and " << meta_file_path << " in " << duration.count() << " ms"
+            << std::endl;
+  return 0;
+}